@@ -1,4 +1,5 @@
 #include "Body.h"
+#include <algorithm>
 #include "../PhysicsWorld.h"
 #include "Hull.h"
 #include "Sphere.h"
@@ -9,10 +10,18 @@ namespace PE {
 Body::Body(PhysicsWorld* physicsWorld)
 {
     m_physicsWorld = physicsWorld;
-    m_index = m_physicsWorld->_addBody(this);
-    m_defaultCollisionGroup = std::shared_ptr<CollisionGroup>(new CollisionGroup);
-    m_currentCollisionGroup = m_defaultCollisionGroup;
+    m_physicsWorld->_addBody(this);
+    m_isPooled = false;
+    m_nextSleeping = nullptr;
+    m_sleepingIsland = 0;
     m_level = 0;
+    m_solverIndex = 0;
+    m_islandNode = 0;
+    m_boundingRadius = 0.0f;
+    m_sweptDistance = 0.0f;
+    m_sweptAngle = 0.0f;
+    m_transformRevision = 0;
+    m_sleepingCheckRevision = 0;
     m_isEnabled = true;
     m_position.set(0.0f, 0.0f, 0.0f);
     m_velocity.set(0.0f, 0.0f, 0.0f);
@@ -26,9 +35,9 @@ Body::Body(PhysicsWorld* physicsWorld)
 Body::~Body()
 {
     while (!m_shapes.empty()) {
-        delete m_shapes[m_shapes.size() - 1];
+        m_physicsWorld->destroyShape(m_shapes[m_shapes.size() - 1]);
     }
-    m_physicsWorld->_removeBody(m_index);
+    m_physicsWorld->_removeBody(this);
 }
 
 std::size_t Body::index() const
@@ -36,6 +45,11 @@ std::size_t Body::index() const
     return m_index;
 }
 
+BodyHandle Body::handle() const
+{
+    return m_handle;
+}
+
 Vector3 Body::position() const
 {
     return m_position;
@@ -44,21 +58,39 @@ Vector3 Body::position() const
 void Body::setPosition(const Vector3& position)
 {
     m_position = position;
+    ++m_transformRevision;
 }
 
-const RotationMatrix& Body::rotation() const
+const Quaternion& Body::orientation() const
 {
-    return m_rotation;
+    return m_orientation;
+}
+
+void Body::setOrientation(const Quaternion& orientation)
+{
+    m_orientation = orientation;
+    m_orientation.normalize();
+    _updateWorldInvInertia();
+    ++m_transformRevision;
+}
+
+RotationMatrix Body::rotation() const
+{
+    return m_orientation.toRotationMatrix();
 }
 
 void Body::setRotation(const Vector3& eulerAngle)
 {
-    m_rotation.fromEulerAngle(eulerAngle);
+    RotationMatrix rotation;
+    rotation.fromEulerAngle(eulerAngle);
+    setRotation(rotation);
 }
 
 void Body::setRotation(const RotationMatrix& rotation)
 {
-    m_rotation = rotation;
+    m_orientation.fromRotationMatrix(rotation);
+    _updateWorldInvInertia();
+    ++m_transformRevision;
 }
 
 Vector3 Body::velocity() const
@@ -122,6 +154,7 @@ void Body::setInertia(const Vector3& inertia)
 {
     for (int i = 0; i < 3; ++i)
         m_invInertia[i] = (inertia[i] > PE_EPSf) ? (1.0f / inertia[i]) : 0.0f;
+    _updateWorldInvInertia();
 }
 #else
 void Body::setInertia(float inertia)
@@ -130,6 +163,15 @@ void Body::setInertia(float inertia)
 }
 #endif
 
+Vector3 Body::invInertiaMul(const Vector3& v) const
+{
+#if (PE_BodyInertia == 3)
+    return m_worldInvInertia * v;
+#else
+    return v * m_invInertia;
+#endif
+}
+
 
 void Body::applyLinearImpulse(const Vector3& normal, float impulse)
 {
@@ -143,24 +185,12 @@ void Body::applyLinearImpulse(const Vector3& lImpulse)
 
 void Body::applyAngularImpulse(const Vector3& rn, float impulse)
 {
-#if (PE_BodyInertia == 3)
-    m_angularVelocity += Vector3(rn.x * m_invInertia.x * impulse,
-                                 rn.y * m_invInertia.y * impulse,
-                                 rn.z * m_invInertia.z * impulse);
-#else
-    m_angularVelocity += rn * (m_invInertia * impulse);
-#endif
+    m_angularVelocity += invInertiaMul(rn * impulse);
 }
 
 void Body::applyAngularImpulse(const Vector3& aImpulse)
 {
-#if (PE_BodyInertia == 3)
-    m_angularVelocity += Vector3(aImpulse.x * m_invInertia.x,
-                                 aImpulse.y * m_invInertia.y,
-                                 aImpulse.z * m_invInertia.z);
-#else
-    m_angularVelocity += aImpulse * m_invInertia;
-#endif
+    m_angularVelocity += invInertiaMul(aImpulse);
 }
 
 void Body::applyImpulse(float impulse, const Vector3& normal, const Vector3& point)
@@ -181,24 +211,12 @@ void Body::applyLinearPseudoImpulse(const Vector3& pseudoLinearImpulse)
 
 void Body::applyAngularPseudoImpulse(const Vector3& rn, float pseudoImpulse)
 {
-#if (PE_BodyInertia == 3)
-    m_pseudoAngularVelocity += Vector3(rn.x * m_invInertia.x * pseudoImpulse,
-                                       rn.y * m_invInertia.y * pseudoImpulse,
-                                       rn.z * m_invInertia.z * pseudoImpulse);
-#else
-    m_pseudoAngularVelocity += rn * (m_invInertia * pseudoImpulse);
-#endif
+    m_pseudoAngularVelocity += invInertiaMul(rn * pseudoImpulse);
 }
 
 void Body::applyAngularPseudoImpulse(const Vector3& pseudoAngularImpulse)
 {
-#if (PE_BodyInertia == 3)
-    m_pseudoAngularVelocity += Vector3(pseudoAngularImpulse.x * m_invInertia.x,
-                                       pseudoAngularImpulse.y * m_invInertia.y,
-                                       pseudoAngularImpulse.z * m_invInertia.z);
-#else
-    m_pseudoAngularVelocity += pseudoAngularImpulse * m_invInertia;
-#endif
+    m_pseudoAngularVelocity += invInertiaMul(pseudoAngularImpulse);
 }
 
 bool Body::isStatic() const
@@ -229,11 +247,7 @@ void Body::calculateLocalInertia()
         Shape* shape = *it;
         switch (shape->type()) {
         case TypeShape::Hull: {
-            Hull* hull = static_cast<Hull*>(shape);
-            for (int j = 0; j < hull->countVertices(); ++j) {
-                bounds.min.minAxis(hull->localVertex(j));
-                bounds.max.maxAxis(hull->localVertex(j));
-            }
+            bounds.merge(static_cast<Hull*>(shape)->getLocalBounds());
         } break;
         case TypeShape::Sphere: {
             Sphere* sphere = static_cast<Sphere*>(shape);
@@ -262,13 +276,19 @@ void Body::calculateLocalInertia()
     m_invInertia = (12.0f) / (d.lengthSquared());
 #endif
     m_invInertia *= m_invMass;
+    _updateWorldInvInertia();
 }
 
 void Body::update(float dt, const Vector3& gravity, float damping)
 {
-    m_position += ((m_velocity + m_pseudoVelocity) * dt);
+    Vector3 delta = (m_velocity + m_pseudoVelocity) * dt;
+    m_position += delta;
+    m_sweptDistance += delta.length();
     m_pseudoAngularVelocity += m_angularVelocity;
-    if (!m_rotation.rotate(m_pseudoAngularVelocity, dt))
+    m_sweptAngle += m_pseudoAngularVelocity.length() * dt;
+    if (m_orientation.rotate(m_pseudoAngularVelocity, dt))
+        _updateWorldInvInertia();
+    else
         m_angularVelocity.set(0.0f, 0.0f, 0.0f);
     m_pseudoVelocity.set(0.0f, 0.0f, 0.0f);
     m_pseudoAngularVelocity.set(0.0f, 0.0f, 0.0f);
@@ -281,13 +301,27 @@ void Body::update(float dt, const Vector3& gravity, float damping)
 
 void Body::updateShapes()
 {
-    for (auto it = m_shapes.begin(); it != m_shapes.end(); ++it)
+    m_boundingRadius = 0.0f;
+    for (auto it = m_shapes.begin(); it != m_shapes.end(); ++it) {
         (*it)->update();
+        m_boundingRadius = std::max(m_boundingRadius, (*it)->boundingRadius());
+    }
 }
 
 void Body::updateBoundsTree()
 {
     m_boundsTrees.update();
+    m_physicsWorld->_mergeSleepingBounds(this);
+}
+
+float Body::boundingRadius() const
+{
+    return m_boundingRadius;
+}
+
+float Body::motionBound() const
+{
+    return m_sweptDistance + m_sweptAngle * m_boundingRadius;
 }
 
 bool Body::isEnabled() const
@@ -300,41 +334,60 @@ void Body::setEnabled(bool enabled)
     m_isEnabled = enabled;
 }
 
-std::shared_ptr<const CollisionGroup> Body::defaultCollionGroup() const
+std::uint32_t Body::defaultCollisionGroupId() const
 {
     return m_defaultCollisionGroup;
 }
 
-std::shared_ptr<const CollisionGroup> Body::currentCollionGroup() const
+std::uint32_t Body::currentCollisionGroupId() const
 {
     return m_currentCollisionGroup;
 }
 
 bool Body::nonSleeping() const
 {
-    return m_currentCollisionGroup->nonSleep;
+    return m_physicsWorld->m_collisionGroups[m_currentCollisionGroup].nonSleep;
+}
+
+void Body::wakeUp()
+{
+    if (!m_physicsWorld->m_collisionGroups[m_defaultCollisionGroup].nonSleep)
+        m_physicsWorld->_wakeUp(this);
 }
 
 Body* Body::copy() const
 {
-    Body* body = new Body(m_physicsWorld);
+    Body* body = m_isPooled ? m_physicsWorld->createBody() : new Body(m_physicsWorld);
     for (auto it = m_shapes.begin(); it != m_shapes.end(); ++it) {
-        (*it)->copy()->setBody(body);
+        Shape* shape = m_isPooled ? m_physicsWorld->createCopy(*it) : (*it)->copy();
+        shape->setBody(body);
     }
     return body;
 }
 
+void Body::_updateWorldInvInertia()
+{
+#if (PE_BodyInertia == 3)
+    m_worldInvInertia.setRotatedDiagonal(m_orientation.toRotationMatrix(), m_invInertia);
+#endif
+}
+
 std::size_t Body::_addShape(Shape* shape)
 {
     m_shapes.push_back(shape);
-    m_boundsTrees.compute(m_shapes);
+    m_boundsTrees.compute(m_shapes, m_physicsWorld->m_scratchArena);
+    m_physicsWorld->_mergeSleepingBounds(this);
+    ++m_transformRevision;
     return m_shapes.size() - 1;
 }
 
 void Body::_removeShape(std::size_t index)
 {
+    m_physicsWorld->_removeShape(m_shapes[index]);
     m_shapes.erase(m_shapes.begin() + index);
-    m_boundsTrees.compute(m_shapes);
+    m_boundsTrees.compute(m_shapes, m_physicsWorld->m_scratchArena);
+    m_physicsWorld->_mergeSleepingBounds(this);
+    ++m_transformRevision;
 }
 
 void Body::_updateContactsOnBody()
@@ -343,23 +396,4 @@ void Body::_updateContactsOnBody()
     m_contacts.resize(0);
 }
 
-void Body::_mergeCollisionGroup(Body* body)
-{
-    if (m_index > body->m_index) {
-        body->m_currentCollisionGroup = m_currentCollisionGroup;
-    } else {
-        m_currentCollisionGroup = body->m_currentCollisionGroup;
-    }
-}
-
-void Body::_mergeCollisionGroupAndAwake(Body* body)
-{
-    if (m_index > body->m_index) {
-        body->m_currentCollisionGroup = m_currentCollisionGroup;
-    } else {
-        m_currentCollisionGroup = body->m_currentCollisionGroup;
-    }
-    m_defaultCollisionGroup->nonSleep = true;
-}
-
 } // namespace PE
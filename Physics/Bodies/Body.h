@@ -2,10 +2,12 @@
 #define PE_BODY_H
 
 #include <cstdlib>
-#include <memory>
+#include <cstdint>
 #include "../Settings.h"
 #include "../VectorMath/Vector3.h"
 #include "../VectorMath/RotationMatrix.h"
+#include "../VectorMath/Quaternion.h"
+#include "../VectorMath/Matrix3.h"
 #include "Shape.h"
 #include "Material.h"
 #include "BoundsTrees.h"
@@ -18,11 +20,23 @@ class ContactTypes;
 class ContactsContainer;
 class Solver;
 class ShockPropagationSolver;
+class SeparationCache;
 
 class Sphere;
 class Hull;
 class Capsule;
 
+// A weak reference to a body, it stops resolving once the body is destroyed even if its slot is reused.
+struct BodyHandle
+{
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+
+    bool operator == (const BodyHandle& handle) const { return (slot == handle.slot) && (generation == handle.generation); }
+    bool operator != (const BodyHandle& handle) const { return !(*this == handle); }
+};
+
+// Sleep state of a body, collision groups are stored by the world and referred to by id.
 struct CollisionGroup
 {
     int time_without_movement = 0;
@@ -36,11 +50,16 @@ public:
     ~Body();
 
     std::size_t index() const;
+    BodyHandle handle() const;
 
     Vector3 position() const;
     void setPosition(const Vector3& position);
 
-    const RotationMatrix& rotation() const;
+    const Quaternion& orientation() const;
+    void setOrientation(const Quaternion& orientation);
+
+    // Built from the orientation on every call, get it once when many vectors are rotated.
+    RotationMatrix rotation() const;
     void setRotation(const Vector3& eulerAngle);
     void setRotation(const RotationMatrix& rotation);
 
@@ -68,6 +87,8 @@ public:
     float inertia() const;
     void setInertia(float inertia);
 #endif
+    // Multiplies by the inverse inertia in world axes, R * I^-1 * R^T, kept up to date with the orientation.
+    Vector3 invInertiaMul(const Vector3& v) const;
 
     void applyLinearImpulse(const Vector3& normal, float impulse);
     void applyLinearImpulse(const Vector3& lImpulse);
@@ -92,13 +113,19 @@ public:
     void updateShapes();
     void updateBoundsTree();
 
+    float boundingRadius() const;
+    float motionBound() const;
+
     bool isEnabled() const;
     void setEnabled(bool enabled);
 
-    std::shared_ptr<const CollisionGroup> defaultCollionGroup() const;
-    std::shared_ptr<const CollisionGroup> currentCollionGroup() const;
+    // The default group belongs to the body, the current one is shared by the bodies of its island.
+    std::uint32_t defaultCollisionGroupId() const;
+    std::uint32_t currentCollisionGroupId() const;
 
     bool nonSleeping() const;
+    // Wakes up the whole sleeping island of the body.
+    void wakeUp();
 
     Body* copy() const;
 
@@ -113,20 +140,27 @@ protected:
     friend class ContactsContainer;
     friend class Solver;
     friend class ShockPropagationSolver;
+    friend class SeparationCache;
 
-    std::shared_ptr<CollisionGroup> m_defaultCollisionGroup;
-    std::shared_ptr<CollisionGroup> m_currentCollisionGroup;
+    std::uint32_t m_defaultCollisionGroup;
+    std::uint32_t m_currentCollisionGroup;
 
     PhysicsWorld* m_physicsWorld;
+    bool m_isPooled;
     std::size_t m_index;
+    BodyHandle m_handle;
+    std::size_t m_awakeIndex;
+    Body* m_nextSleeping;
+    std::size_t m_sleepingIsland;
     Vector3 m_position;
-    RotationMatrix m_rotation;
+    Quaternion m_orientation;
     Vector3 m_velocity, m_angularVelocity;
     Vector3 m_pseudoVelocity, m_pseudoAngularVelocity;
 
     float m_invMass;
 #if (PE_BodyInertia == 3)
     Vector3 m_invInertia;
+    Matrix3 m_worldInvInertia;
 #else
     float m_invInertia;
 #endif
@@ -135,18 +169,24 @@ protected:
     std::vector<int> m_contacts;
     std::vector<int> m_prev_contacts;
     int m_level;
+    std::uint32_t m_solverIndex;
+    std::uint32_t m_islandNode;
+
+    float m_boundingRadius;
+    float m_sweptDistance;
+    float m_sweptAngle;
+    unsigned int m_transformRevision;
+    unsigned int m_sleepingCheckRevision;
 
     std::vector<Shape*> m_shapes;
 
     BoundsTree m_boundsTrees;
 
+    void _updateWorldInvInertia();
     std::size_t _addShape(Shape* shape);
     void _removeShape(std::size_t index);
     void _updateContactsOnBody();
 
-    void _mergeCollisionGroup(Body* body);
-    void _mergeCollisionGroupAndAwake(Body* body);
-
 
 };
 
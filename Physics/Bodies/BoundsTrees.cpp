@@ -33,12 +33,12 @@ BoundsTree::Node& BoundsTree::node(int index)
     return m_nodes[index];
 }
 
-void BoundsTree::compute(const std::vector<Shape*>& shapes)
+void BoundsTree::compute(const std::vector<Shape*>& shapes, ScratchArena& scratchArena)
 {
     if (shapes.empty())
         return;
     m_nodes.resize(1);
-    _computeNode(0, shapes);
+    _computeNode(0, shapes.data(), shapes.size(), scratchArena);
 }
 
 void BoundsTree::update()
@@ -48,10 +48,11 @@ void BoundsTree::update()
     _computeBounds(0);
 }
 
-void BoundsTree::_computeNode(std::size_t indexNode, const std::vector<Shape*>& shapes)
+void BoundsTree::_computeNode(std::size_t indexNode, Shape* const* shapes, std::size_t countShapes,
+                              ScratchArena& scratchArena)
 {
-    if (shapes.size() <= 1) {
-        if (shapes.size() == 0) {
+    if (countShapes <= 1) {
+        if (countShapes == 0) {
             m_nodes[indexNode].shape = nullptr;
             m_nodes[indexNode].bounds.init();
             assert(false);
@@ -61,11 +62,12 @@ void BoundsTree::_computeNode(std::size_t indexNode, const std::vector<Shape*>&
         }
         return;
     }
+    ScratchScope scratchScope(scratchArena);
     m_nodes[indexNode].bounds.init();
-    Bounds* localBounds = new Bounds[shapes.size()];
+    Bounds* localBounds = scratchArena.allocate<Bounds>(countShapes);
     Vector3 center(0.0f, 0.0f, 0.0f);
     std::size_t i;
-    for (i = 0; i < shapes.size(); ++i) {
+    for (i = 0; i < countShapes; ++i) {
         localBounds[i] = shapes[i]->getLocalBounds();
         m_nodes[indexNode].bounds.min.minAxis(localBounds[i].min);
         m_nodes[indexNode].bounds.max.maxAxis(localBounds[i].max);
@@ -76,28 +78,28 @@ void BoundsTree::_computeNode(std::size_t indexNode, const std::vector<Shape*>&
     if (d.z > d[indexMaxAxis])
         indexMaxAxis = 2;
     float center_x = center[indexMaxAxis];
-    std::vector<Shape*> shapesA;
-    std::vector<Shape*> shapesB;
-    for (i = 0; i < shapes.size(); ++i) {
+    // Shapes of the first half are gathered from the front of the array, of the second one from the back.
+    Shape** splitShapes = scratchArena.allocate<Shape*>(countShapes);
+    std::size_t countShapesA = 0, countShapesB = 0;
+    for (i = 0; i < countShapes; ++i) {
         if (localBounds[i].getCenter()[indexMaxAxis] < center_x)
-            shapesA.push_back(shapes[i]);
+            splitShapes[countShapesA++] = shapes[i];
         else
-            shapesB.push_back(shapes[i]);
+            splitShapes[countShapes - (++countShapesB)] = shapes[i];
     }
-    delete[] localBounds;
     m_nodes.resize(m_nodes.size() + 2);
     m_nodes[indexNode].indexA = m_nodes.size() - 2;
     m_nodes[indexNode].indexB = m_nodes.size() - 1;
     m_nodes[indexNode].shape = nullptr;
-    if (shapesA.empty()) {
-        shapesA.push_back(*(shapesB.begin() + (shapesB.size() - 1)));
-        shapesB.resize(shapesB.size() - 1);
-    } else if (shapesB.empty()) {
-        shapesB.push_back(*(shapesA.begin() + (shapesA.size() - 1)));
-        shapesA.resize(shapesA.size() - 1);
+    if (countShapesA == 0) {
+        ++countShapesA;
+        --countShapesB;
+    } else if (countShapesB == 0) {
+        --countShapesA;
+        ++countShapesB;
     }
-    _computeNode(m_nodes[indexNode].indexA, shapesA);
-    _computeNode(m_nodes[indexNode].indexB, shapesB);
+    _computeNode(m_nodes[indexNode].indexA, splitShapes, countShapesA, scratchArena);
+    _computeNode(m_nodes[indexNode].indexB, splitShapes + countShapesA, countShapesB, scratchArena);
 }
 
 Bounds BoundsTree::_computeBounds(size_t indexNode)
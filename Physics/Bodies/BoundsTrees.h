@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "Shape.h"
+#include "../Memory/ScratchArena.h"
 
 namespace PE {
 
@@ -24,14 +25,14 @@ public:
     Node& rootNode();
     Node& node(int index);
 
-    void compute(const std::vector<Shape*>& shapes);
+    void compute(const std::vector<Shape*>& shapes, ScratchArena& scratchArena);
 
     void update();
 
 private:
     std::vector<Node> m_nodes;
 
-    void _computeNode(size_t indexNode, const std::vector<Shape*>& shapes);
+    void _computeNode(size_t indexNode, Shape* const* shapes, std::size_t countShapes, ScratchArena& scratchArena);
     Bounds _computeBounds(std::size_t indexNode);
 };
 
@@ -37,6 +37,7 @@ float Capsule::radius() const
 void Capsule::setRadius(float radius)
 {
     m_radius = radius;
+    _geometryChanged();
 }
 
 Vector3 Capsule::localVertexA() const
@@ -64,6 +65,7 @@ void Capsule::setLocalVertices(const Vector3& vertexA, const Vector3& vertexB)
     m_local_vertices[0] = vertexA;
     m_local_vertices[1] = vertexB;
     _updateDir();
+    _geometryChanged();
 }
 
 Vector3 Capsule::localDir() const
@@ -87,6 +89,11 @@ void Capsule::_updateDir()
     m_length = m_local_dir.normalize();
 }
 
+float Capsule::boundingRadius() const
+{
+    return Shape::boundingRadius() + m_radius;
+}
+
 Shape* Capsule::copy() const
 {
     Capsule* capsule = new Capsule();
@@ -101,9 +108,9 @@ Shape* Capsule::copy() const
 
 void Capsule::update()
 {
-    m_global_vertices[0] = m_body->position() + m_body->rotation().vectorRotated(m_local_vertices[0]);
-    m_global_vertices[1] = m_body->position()+ m_body->rotation().vectorRotated(m_local_vertices[1]);
-    m_global_dir = m_body->rotation().vectorRotated(m_local_dir);
+    m_global_vertices[0] = m_body->position() + m_body->orientation().vectorRotated(m_local_vertices[0]);
+    m_global_vertices[1] = m_body->position()+ m_body->orientation().vectorRotated(m_local_vertices[1]);
+    m_global_dir = m_body->orientation().vectorRotated(m_local_dir);
     m_bounds.min = m_global_vertices[0];
     m_bounds.min.minAxis(m_global_vertices[1]);
     m_bounds.min -= Vector3(m_radius, m_radius, m_radius);
@@ -25,6 +25,8 @@ public:
     Vector3 dir() const;
     float length();
 
+    float boundingRadius() const override;
+
     Shape* copy() const override;
     void update() override;
 
@@ -0,0 +1,156 @@
+#include "ConvexGeometry.h"
+#include <cmath>
+#include <algorithm>
+#include "QuickHull.h"
+
+namespace PE {
+
+ConvexGeometry::ConvexGeometry()
+{
+    m_bounds.init();
+    m_boundingRadius = 0.0f;
+}
+
+int ConvexGeometry::countVertices() const
+{
+    return (int)m_vertices.size();
+}
+
+const Vector3& ConvexGeometry::vertex(int index) const
+{
+    return m_vertices[index];
+}
+
+const std::vector<Vector3>& ConvexGeometry::vertices() const
+{
+    return m_vertices;
+}
+
+int ConvexGeometry::countPolygons() const
+{
+    return (int)m_polygonNormals.size();
+}
+
+Polygon ConvexGeometry::polygon(int index) const
+{
+    Polygon polygon;
+    polygon.vertices = m_polygonIndices.data() + m_polygonOffsets[index];
+    polygon.countVertices = m_polygonCounts[index];
+    polygon.normal = m_polygonNormals[index];
+    return polygon;
+}
+
+const Vector3& ConvexGeometry::polygonNormal(int index) const
+{
+    return m_polygonNormals[index];
+}
+
+const std::vector<int>& ConvexGeometry::polygonIndices() const
+{
+    return m_polygonIndices;
+}
+
+const std::vector<int>& ConvexGeometry::polygonCounts() const
+{
+    return m_polygonCounts;
+}
+
+const std::vector<Vector3>& ConvexGeometry::polygonNormals() const
+{
+    return m_polygonNormals;
+}
+
+Bounds ConvexGeometry::bounds() const
+{
+    return m_bounds;
+}
+
+float ConvexGeometry::boundingRadius() const
+{
+    return m_boundingRadius;
+}
+
+std::shared_ptr<const ConvexGeometry> ConvexGeometry::create(const std::vector<Vector3>& vertices, float epsinon,
+                                                             int maxCountVerticesOnPoligon, int maxCountPoligons)
+{
+    std::shared_ptr<ConvexGeometry> geometry = std::make_shared<ConvexGeometry>();
+    geometry->m_vertices = vertices;
+    if (!geometry->_formedHull(epsinon, maxCountVerticesOnPoligon, maxCountPoligons))
+        return nullptr;
+    return geometry;
+}
+
+std::shared_ptr<const ConvexGeometry> ConvexGeometry::create(const std::vector<Vector3>& vertices,
+                                                             const std::vector<int>& polygonIndices,
+                                                             const std::vector<int>& polygonCounts,
+                                                             const std::vector<Vector3>& polygonNormals)
+{
+    std::shared_ptr<ConvexGeometry> geometry = std::make_shared<ConvexGeometry>();
+    geometry->m_vertices = vertices;
+    geometry->m_polygonIndices = polygonIndices;
+    geometry->m_polygonCounts = polygonCounts;
+    geometry->m_polygonNormals = polygonNormals;
+    geometry->m_polygonOffsets.resize(polygonCounts.size());
+    int offset = 0;
+    for (std::size_t i = 0; i < polygonCounts.size(); ++i) {
+        geometry->m_polygonOffsets[i] = offset;
+        offset += polygonCounts[i];
+    }
+    geometry->_updateBounds();
+    return geometry;
+}
+
+std::shared_ptr<const ConvexGeometry> ConvexGeometry::createCube(const Vector3& scale)
+{
+    std::vector<Vector3> vertices(8);
+    vertices[0].set(scale.x, scale.y, scale.z);
+    vertices[1].set(scale.x, scale.y, - scale.z);
+    vertices[2].set(scale.x, - scale.y, scale.z);
+    vertices[3].set(scale.x, - scale.y, - scale.z);
+    vertices[4].set(- scale.x, scale.y, scale.z);
+    vertices[5].set(- scale.x, scale.y, - scale.z);
+    vertices[6].set(- scale.x, - scale.y, scale.z);
+    vertices[7].set(- scale.x, - scale.y, - scale.z);
+    return create(vertices);
+}
+
+bool ConvexGeometry::_formedHull(float epsinon, int maxCountVerticesOnPoligon, int maxCountPoligons)
+{
+    QuickHull algoritm;
+    bool result = algoritm.qHull(this, epsinon, maxCountVerticesOnPoligon, maxCountPoligons);
+    _updateBounds();
+    return result;
+}
+
+void ConvexGeometry::_clearPolygons()
+{
+    m_polygonIndices.clear();
+    m_polygonOffsets.clear();
+    m_polygonCounts.clear();
+    m_polygonNormals.clear();
+}
+
+void ConvexGeometry::_beginPolygon(const Vector3& normal)
+{
+    m_polygonOffsets.push_back((int)m_polygonIndices.size());
+    m_polygonNormals.push_back(normal);
+}
+
+void ConvexGeometry::_endPolygon()
+{
+    m_polygonCounts.push_back((int)m_polygonIndices.size() - m_polygonOffsets.back());
+}
+
+void ConvexGeometry::_updateBounds()
+{
+    m_bounds.init();
+    float maxLengthSquared = 0.0f;
+    for (auto it = m_vertices.begin(); it != m_vertices.end(); ++it) {
+        m_bounds.min.minAxis(*it);
+        m_bounds.max.maxAxis(*it);
+        maxLengthSquared = std::max(maxLengthSquared, it->lengthSquared());
+    }
+    m_boundingRadius = std::sqrt(maxLengthSquared);
+}
+
+} // namespace PE
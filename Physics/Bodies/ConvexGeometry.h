@@ -0,0 +1,76 @@
+#ifndef PE_CONVEXGEOMETRY_H
+#define PE_CONVEXGEOMETRY_H
+
+#include <vector>
+#include <memory>
+#include "Shape.h"
+
+namespace PE {
+
+// One face of a convex geometry, vertices point into the index buffer of the geometry.
+struct Polygon
+{
+    const int* vertices;
+    int countVertices;
+    Vector3 normal;
+};
+
+class QuickHull;
+class Hull;
+
+// Local vertices and polygons of a convex hull, shared by all hulls built from the same data.
+// Vertex indices of all polygons are stored in one buffer, bounds and bounding radius are computed
+// once when the geometry is built.
+class ConvexGeometry
+{
+public:
+    ConvexGeometry();
+
+    int countVertices() const;
+    const Vector3& vertex(int index) const;
+    const std::vector<Vector3>& vertices() const;
+
+    int countPolygons() const;
+    Polygon polygon(int index) const;
+    const Vector3& polygonNormal(int index) const;
+
+    const std::vector<int>& polygonIndices() const;
+    const std::vector<int>& polygonCounts() const;
+    const std::vector<Vector3>& polygonNormals() const;
+
+    Bounds bounds() const;
+    float boundingRadius() const;
+
+    static std::shared_ptr<const ConvexGeometry> create(const std::vector<Vector3>& vertices,
+                                                        float epsinon = PE_DefaultEpsilonConvexHull,
+                                                        int maxCountVerticesOnPoligon = PE_DefaultMaxCountVerticesOnPoligonsOnConvexHull,
+                                                        int maxCountPoligons = PE_DefaultMaxCountPoligonsOnConvexHull);
+    // Makes a geometry from an already built hull without running QuickHull.
+    static std::shared_ptr<const ConvexGeometry> create(const std::vector<Vector3>& vertices,
+                                                        const std::vector<int>& polygonIndices,
+                                                        const std::vector<int>& polygonCounts,
+                                                        const std::vector<Vector3>& polygonNormals);
+    static std::shared_ptr<const ConvexGeometry> createCube(const Vector3& scale = Vector3(1.0f, 1.0f, 1.0f));
+
+private:
+    friend class QuickHull;
+    friend class Hull;
+
+    std::vector<Vector3> m_vertices;
+    std::vector<int> m_polygonIndices;
+    std::vector<int> m_polygonOffsets;
+    std::vector<int> m_polygonCounts;
+    std::vector<Vector3> m_polygonNormals;
+    Bounds m_bounds;
+    float m_boundingRadius;
+
+    bool _formedHull(float epsinon, int maxCountVerticesOnPoligon, int maxCountPoligons);
+    void _clearPolygons();
+    void _beginPolygon(const Vector3& normal);
+    void _endPolygon();
+    void _updateBounds();
+};
+
+} // namespace PE
+
+#endif // PE_CONVEXGEOMETRY_H
@@ -1,6 +1,5 @@
 #include "Hull.h"
 #include "../VectorMath/RotationMatrix.h"
-#include "QuickHull.h"
 #include "Body.h"
 
 namespace PE {
@@ -9,48 +8,83 @@ Hull::Hull():
     Shape()
 {
     m_type = TypeShape::Hull;
+    m_geometry = std::make_shared<ConvexGeometry>();
+    m_isGeometryOwned = true;
 }
 
+Hull::Hull(const std::shared_ptr<const ConvexGeometry>& geometry):
+    Shape()
+{
+    m_type = TypeShape::Hull;
+    m_geometry = geometry;
+    m_isGeometryOwned = false;
+    m_global_vertices.resize(m_geometry->countVertices());
+}
+
+std::shared_ptr<const ConvexGeometry> Hull::geometry() const
+{
+    return m_geometry;
+}
+
+void Hull::setGeometry(const std::shared_ptr<const ConvexGeometry>& geometry)
+{
+    m_geometry = geometry;
+    m_isGeometryOwned = false;
+    m_global_vertices.resize(m_geometry->countVertices());
+    _geometryChanged();
+}
 
 void Hull::setLocalVertex(int index, float x, float y, float z)
 {
-    m_local_vertices[index].set(x, y, z);
+    ConvexGeometry& geometry = _ownGeometry();
+    geometry.m_vertices[index].set(x, y, z);
+    geometry._updateBounds();
 }
 
 void Hull::setLocalVertex(int index, const Vector3& vertex)
 {
-    m_local_vertices[index] = vertex;
+    ConvexGeometry& geometry = _ownGeometry();
+    geometry.m_vertices[index] = vertex;
+    geometry._updateBounds();
 }
 
 void Hull::setCountVertices(int count)
 {
-    m_local_vertices.resize(count);
+    ConvexGeometry& geometry = _ownGeometry();
+    geometry.m_vertices.resize(count);
+    geometry._updateBounds();
     m_global_vertices.resize(count);
 }
 
 void Hull::setVertices(const std::vector<Vector3>& vertices)
 {
-    m_local_vertices = vertices;
+    ConvexGeometry& geometry = _ownGeometry();
+    geometry.m_vertices = vertices;
+    geometry._updateBounds();
     m_global_vertices.resize(vertices.size());
 }
 
 void Hull::moveLocalVertices(const Vector3& v)
 {
-    for (auto it = m_local_vertices.begin(); it != m_local_vertices.end(); ++it) {
+    ConvexGeometry& geometry = _ownGeometry();
+    for (auto it = geometry.m_vertices.begin(); it != geometry.m_vertices.end(); ++it) {
         *it += v;
     }
+    geometry._updateBounds();
 }
 
 void Hull::scaleLocalVertices(const Vector3& scale)
 {
-    for (auto it = m_local_vertices.begin(); it != m_local_vertices.end(); ++it) {
+    ConvexGeometry& geometry = _ownGeometry();
+    for (auto it = geometry.m_vertices.begin(); it != geometry.m_vertices.end(); ++it) {
         it->set(it->x * scale.x, it->y * scale.y, it->z * scale.z);
     }
+    geometry._updateBounds();
 }
 
 Vector3 Hull::localVertex(int index) const
 {
-    return m_local_vertices[index];
+    return m_geometry->vertex(index);
 }
 
 Vector3 Hull::vertex(int index) const
@@ -60,31 +94,42 @@ Vector3 Hull::vertex(int index) const
 
 int Hull::countPolygons() const
 {
-    return (int)m_polygons.size();
+    return m_geometry->countPolygons();
+}
+
+Polygon Hull::polygon(int index) const
+{
+    return m_geometry->polygon(index);
+}
+
+const Vector3& Hull::polygonNormal(int index) const
+{
+    return m_geometry->polygonNormal(index);
 }
 
-Polygon& Hull::polygon(int index)
+Bounds Hull::getLocalBounds() const
 {
-    return m_polygons[index];
+    return m_geometry->bounds();
 }
 
-const Polygon& Hull::polygon(int index) const
+float Hull::boundingRadius() const
 {
-    return m_polygons[index];
+    return m_geometry->boundingRadius();
 }
 
 bool Hull::formedHull(float epsinon, int maxCountVerticesOnPoligon, int maxCountPoligons)
 {
-    QuickHull algoritm;
-    return algoritm.qHull(this, epsinon, maxCountVerticesOnPoligon, maxCountPoligons);
+    ConvexGeometry& geometry = _ownGeometry();
+    bool result = geometry._formedHull(epsinon, maxCountVerticesOnPoligon, maxCountPoligons);
+    m_global_vertices.resize(geometry.countVertices());
+    return result;
 }
 
 Shape* Hull::copy() const
 {
-    Hull* hull = new Hull();
-    hull->m_local_vertices = m_local_vertices;
+    Hull* hull = new Hull(m_geometry);
+    hull->m_isGeometryOwned = m_isGeometryOwned;
     hull->m_global_vertices = m_global_vertices;
-    hull->m_polygons = m_polygons;
     hull->m_material = m_material;
     return hull;
 }
@@ -93,10 +138,11 @@ void Hull::update()
 {
     m_bounds.init();
 
-    const RotationMatrix& rotation = m_body->rotation();
+    const std::vector<Vector3>& localVertices = m_geometry->m_vertices;
+    RotationMatrix rotation = m_body->rotation();
     Vector3 position = m_body->position();
-    for (std::size_t i = 0; i < m_local_vertices.size(); ++i) {
-        m_global_vertices[i] = rotation.vectorRotated(m_local_vertices[i]) + position;
+    for (std::size_t i = 0; i < localVertices.size(); ++i) {
+        m_global_vertices[i] = rotation.vectorRotated(localVertices[i]) + position;
         m_bounds.min.minAxis(m_global_vertices[i]);
         m_bounds.max.maxAxis(m_global_vertices[i]);
     }
@@ -104,20 +150,23 @@ void Hull::update()
 
 Hull* Hull::creeateCube(const Vector3& scale)
 {
-    Hull* cube = new Hull();
-    cube->m_local_vertices.resize(8);
-    cube->m_global_vertices.resize(8);
-    cube->m_local_vertices[0].set(scale.x, scale.y, scale.z);
-    cube->m_local_vertices[1].set(scale.x, scale.y, - scale.z);
-    cube->m_local_vertices[2].set(scale.x, - scale.y, scale.z);
-    cube->m_local_vertices[3].set(scale.x, - scale.y, - scale.z);
-    cube->m_local_vertices[4].set(- scale.x, scale.y, scale.z);
-    cube->m_local_vertices[5].set(- scale.x, scale.y, - scale.z);
-    cube->m_local_vertices[6].set(- scale.x, - scale.y, scale.z);
-    cube->m_local_vertices[7].set(- scale.x, - scale.y, - scale.z);
-    cube->formedHull();
-    return cube;
+    return new Hull(ConvexGeometry::createCube(scale));
 }
 
-} // namespace PE
+const std::vector<Vector3>& Hull::_localVertices() const
+{
+    return m_geometry->m_vertices;
+}
+
+ConvexGeometry& Hull::_ownGeometry()
+{
+    // A geometry that other hulls can see is never changed in place.
+    if (!m_isGeometryOwned || (m_geometry.use_count() > 1)) {
+        m_geometry = std::make_shared<ConvexGeometry>(*m_geometry);
+        m_isGeometryOwned = true;
+    }
+    _geometryChanged();
+    return const_cast<ConvexGeometry&>(*m_geometry);
+}
 
+} // namespace PE
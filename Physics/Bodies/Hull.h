@@ -2,23 +2,23 @@
 #define PE_HULL_H
 
 #include <vector>
+#include <memory>
 #include "Shape.h"
+#include "ConvexGeometry.h"
 
 namespace PE {
 
-struct Polygon
-{
-    std::vector<int> vertices;
-    Vector3 normal;
-};
-
-class QuickHull;
-
+// Vertices and polygons live in a ConvexGeometry shared between copies of the hull, changing them
+// gives the hull its own geometry first.
 class Hull:
         public Shape
 {
 public:
     Hull();
+    Hull(const std::shared_ptr<const ConvexGeometry>& geometry);
+
+    std::shared_ptr<const ConvexGeometry> geometry() const;
+    void setGeometry(const std::shared_ptr<const ConvexGeometry>& geometry);
 
     void setLocalVertex(int index, float x, float y, float z);
     void setLocalVertex(int index, const Vector3& localVertex);
@@ -34,8 +34,11 @@ public:
     Vector3 vertex(int index) const;
 
     int countPolygons() const;
-    Polygon& polygon(int index);
-    const Polygon& polygon(int index) const;
+    Polygon polygon(int index) const;
+    const Vector3& polygonNormal(int index) const;
+
+    Bounds getLocalBounds() const override;
+    float boundingRadius() const override;
 
     bool formedHull(float epsinon = PE_DefaultEpsilonConvexHull,
                     int maxCountVerticesOnPoligon = PE_DefaultMaxCountVerticesOnPoligonsOnConvexHull,
@@ -47,10 +50,14 @@ public:
 
     static Hull* creeateCube(const Vector3& scale = Vector3(1.0f, 1.0f, 1.0f));
 
+protected:
+    const std::vector<Vector3>& _localVertices() const override;
+
 private:
-    friend class QuickHull;
+    std::shared_ptr<const ConvexGeometry> m_geometry;
+    bool m_isGeometryOwned;
 
-    std::vector<Polygon> m_polygons;
+    ConvexGeometry& _ownGeometry();
 };
 
 } // namespace PE
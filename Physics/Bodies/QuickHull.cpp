@@ -1,16 +1,17 @@
 #include "QuickHull.h"
 #include <utility>
 #include "../CollisionDetected/GJK.h"
+#include "../Memory/ScratchArena.h"
 
 namespace PE {
 
-bool QuickHull::qHull(Hull* hull, float epsilon, int maxCountVerticesOnPoligon, int maxCountTriangles)
+bool QuickHull::qHull(ConvexGeometry* geometry, float epsilon, int maxCountVerticesOnPoligon, int maxCountTriangles)
 {
-    m_hull = hull;
-    int countVertices = m_hull->countVertices();
+    m_geometry = geometry;
+    int countVertices = m_geometry->countVertices();
     if (countVertices < 3)
         return false;
-    m_vertices = m_hull->m_local_vertices;
+    m_vertices = m_geometry->m_vertices;
     m_tempTrianglesStore.clear();
     int i, j, index;
     m_center = 0.0f;
@@ -24,7 +25,9 @@ bool QuickHull::qHull(Hull* hull, float epsilon, int maxCountVerticesOnPoligon,
     if (_formedBasedTetras(maxCountTriangles, tetras))
         return true;
     float set, max;
-    int* vertices_used = new int[countVertices];
+    ScratchArena& scratchArena = ScratchArena::local();
+    ScratchScope scratchScope(scratchArena);
+    int* vertices_used = scratchArena.allocate<int>(countVertices);
     for (i = 0; i < countVertices; ++i)
         vertices_used[i] = -1;
     for (i = 0, ++m_iteration; i < (int)m_tempTrianglesStore.size(); i++, ++m_iteration) {
@@ -44,17 +47,17 @@ bool QuickHull::qHull(Hull* hull, float epsilon, int maxCountVerticesOnPoligon,
             }
         }
     }
-    m_poligons.clear();
-    Polygon polygon;
+    m_geometry->_clearPolygons();
+    Vector3 normal;
     for (i = 0; i < (int)m_tempTrianglesStore.size(); ++i) {
         if (m_tempTrianglesStore[i].valid) {
-            polygon.vertices.resize(0);
-            polygon.normal = m_tempTrianglesStore[i].dir;
-            polygon.normal.normalize();
-            _trianglesToPoligons(polygon, i, 0, vertices_used);
-            _trianglesToPoligons(polygon, i, 1, vertices_used);
-            _trianglesToPoligons(polygon, i, 2, vertices_used);
-            m_poligons.push_back(polygon);
+            normal = m_tempTrianglesStore[i].dir;
+            normal.normalize();
+            m_geometry->_beginPolygon(normal);
+            _trianglesToPoligons(normal, i, 0, vertices_used);
+            _trianglesToPoligons(normal, i, 1, vertices_used);
+            _trianglesToPoligons(normal, i, 2, vertices_used);
+            m_geometry->_endPolygon();
         }
     }
     std::vector<Vector3> tempVertices;
@@ -65,14 +68,11 @@ bool QuickHull::qHull(Hull* hull, float epsilon, int maxCountVerticesOnPoligon,
             vertices_used[i] = tempVertices.size() - 1;
         }
     }
-    m_hull->m_local_vertices = std::move(tempVertices);
-    for (i = 0; i < (int)m_poligons.size(); ++i) {
-        for (j = 0; j < (int)m_poligons[i].vertices.size(); j++)
-            m_poligons[i].vertices[j] = vertices_used[m_poligons[i].vertices[j]];
-    }
-    m_hull->m_polygons = std::move(m_poligons);
+    m_geometry->m_vertices = std::move(tempVertices);
+    std::vector<int>& polygonIndices = m_geometry->m_polygonIndices;
+    for (i = 0; i < (int)polygonIndices.size(); ++i)
+        polygonIndices[i] = vertices_used[polygonIndices[i]];
     m_tempTrianglesStore.clear();
-    delete[] vertices_used;
     return true;
 }
 
@@ -125,7 +125,7 @@ bool QuickHull::_findBasedTetras(int* tetras)
     Vector3 dir, simplex[3];
     dir.set(1.0f, 0.0f, 0.0f);
     bool flag = false;
-    int i, j, n, countVertices = m_hull->countVertices();
+    int i, j, n, countVertices = m_geometry->countVertices();
     float min, min1, set;
     for (j = 0; ; j++) {
         tetras[0] = 0;
@@ -269,10 +269,12 @@ bool QuickHull::_findBasedTetras(int* tetras)
 bool QuickHull::_formedBasedTetras(int maxCountTriangles, int* tetras)
 {
     if (tetras[3] < 0) {
-        int countVertices = m_hull->countVertices();
+        int countVertices = m_geometry->countVertices();
         if (countVertices > 3) {
-            int* usedVertices = new int[countVertices], i, countTempVertices = 0;
-            Vector3* temp = new Vector3[countVertices];
+            ScratchArena& scratchArena = ScratchArena::local();
+            ScratchScope scratchScope(scratchArena);
+            int* usedVertices = scratchArena.allocate<int>(countVertices), i, countTempVertices = 0;
+            Vector3* temp = scratchArena.allocate<Vector3>(countVertices);
             for (i = 0; i < countVertices; ++i)
                 usedVertices[i] = -1;
             usedVertices[tetras[0]] = tetras[0];
@@ -284,35 +286,34 @@ bool QuickHull::_formedBasedTetras(int maxCountTriangles, int* tetras)
                     ++countTempVertices;
                 }
             }
-            m_hull->setCountVertices(countTempVertices);
-            m_vertices = m_hull->m_local_vertices;
+            m_geometry->m_vertices.resize(countTempVertices);
+            m_vertices = m_geometry->m_vertices;
             for (i = 0; i < countTempVertices; ++i)
                 m_vertices[i] = temp[i];
-            delete[] temp;
-            delete[] usedVertices;
         }
-        m_poligons.resize(2);
-        m_poligons[0].normal = cross((m_vertices[1] - m_vertices[0]), (m_vertices[2] - m_vertices[0]));
-        m_poligons[0].normal.normalize();
-        m_poligons[0].vertices.resize(3);
-        m_poligons[0].vertices[0] = 0;
-        m_poligons[0].vertices[1] = 1;
-        m_poligons[0].vertices[2] = 2;
-        m_poligons[1].normal = - m_poligons[0].normal;
-        m_poligons[1].vertices.resize(3);
-        m_poligons[1].vertices[0] = 0;
-        m_poligons[1].vertices[1] = 2;
-        m_poligons[1].vertices[2] = 1;
-        m_hull->m_polygons = m_poligons;
+        Vector3 normal = cross((m_vertices[1] - m_vertices[0]), (m_vertices[2] - m_vertices[0]));
+        normal.normalize();
+        std::vector<int>& polygonIndices = m_geometry->m_polygonIndices;
+        m_geometry->_clearPolygons();
+        m_geometry->_beginPolygon(normal);
+        polygonIndices.push_back(0);
+        polygonIndices.push_back(1);
+        polygonIndices.push_back(2);
+        m_geometry->_endPolygon();
+        m_geometry->_beginPolygon(- normal);
+        polygonIndices.push_back(0);
+        polygonIndices.push_back(2);
+        polygonIndices.push_back(1);
+        m_geometry->_endPolygon();
         return true; // completed hull (1 triangle)
     }
     m_iteration = 0;
     m_tempTrianglesStore.clear();
     Vector3 v[4];
-    v[0] = m_hull->m_local_vertices[tetras[0]];
-    v[1] = m_hull->m_local_vertices[tetras[1]];
-    v[2] = m_hull->m_local_vertices[tetras[2]];
-    v[3] = m_hull->m_local_vertices[tetras[3]];
+    v[0] = m_geometry->m_vertices[tetras[0]];
+    v[1] = m_geometry->m_vertices[tetras[1]];
+    v[2] = m_geometry->m_vertices[tetras[2]];
+    v[3] = m_geometry->m_vertices[tetras[3]];
 
     Vector3 vec1 = v[1] - v[0];
     Vector3 vec2 = v[2] - v[0];
@@ -427,20 +428,20 @@ bool QuickHull::_addVertexToConvex(int indexTriangle, int newVertex)
     return true;
 }
 
-void QuickHull::_trianglesToPoligons(Polygon& polygon,
+void QuickHull::_trianglesToPoligons(const Vector3& normal,
                                      int indexTriangle, int index, int* usedVertices)
 {
     int joinedTriangle = m_tempTrianglesStore[indexTriangle].joined[index], findex;
-    if (polygon.normal.equalDir(m_tempTrianglesStore[joinedTriangle].dir)) {
+    if (normal.equalDir(m_tempTrianglesStore[joinedTriangle].dir)) {
         if (!m_tempTrianglesStore[joinedTriangle].valid)
             return;
         m_tempTrianglesStore[joinedTriangle].valid = false;
         findex = _getIndexJoinedTempTriangle(joinedTriangle, indexTriangle);
-        _trianglesToPoligons(polygon, joinedTriangle, (findex + 1) % 3, usedVertices);
-        _trianglesToPoligons(polygon, joinedTriangle, (findex + 2) % 3, usedVertices);
+        _trianglesToPoligons(normal, joinedTriangle, (findex + 1) % 3, usedVertices);
+        _trianglesToPoligons(normal, joinedTriangle, (findex + 2) % 3, usedVertices);
     } else {
         findex = m_tempTrianglesStore[indexTriangle].vertices[index];
-        polygon.vertices.push_back(findex);
+        m_geometry->m_polygonIndices.push_back(findex);
         usedVertices[findex] = findex;
     }
 }
@@ -3,14 +3,14 @@
 
 #include <vector>
 #include "../VectorMath/Vector3.h"
-#include "Hull.h"
+#include "ConvexGeometry.h"
 
 namespace PE {
 
 class QuickHull
 {
 public:
-    bool qHull(Hull* hull,
+    bool qHull(ConvexGeometry* geometry,
                float epsinon = PE_DefaultEpsilonConvexHull,
                int maxCountVerticesOnPoligon = PE_DefaultMaxCountVerticesOnPoligonsOnConvexHull,
                int maxCountPoligons = PE_DefaultMaxCountPoligonsOnConvexHull);
@@ -25,9 +25,8 @@ private:
         bool valid;
     } TempTriangle;
 
-    Hull* m_hull;
+    ConvexGeometry* m_geometry;
     float m_epsilon;
-    std::vector<Polygon> m_poligons;
     std::vector<Vector3> m_vertices;
     Vector3 m_center;
     std::vector<TempTriangle> m_tempTrianglesStore;
@@ -43,7 +42,7 @@ private:
     bool _addVertexToConvex(int indexTriangle, int newVertex);
     int _getJoinedTempTriangle(int indexTriangle, int indexEdge);
     int _getIndexJoinedTempTriangle(int indexBasedTriangle, int indexJoinedTriangle) const;
-    void _trianglesToPoligons(Polygon& polygon, int indexTriangle, int index, int* usedVertex);
+    void _trianglesToPoligons(const Vector3& normal, int indexTriangle, int index, int* usedVertex);
 };
 
 } // namespace PE
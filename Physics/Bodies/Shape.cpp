@@ -2,13 +2,71 @@
 #include "Body.h"
 #include <climits>
 #include <limits>
+#include <algorithm>
+
+#if (PE_SupportSIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define PE_SUPPORT_SSE2
+#include "../VectorMath/Vector3x4.h"
+#endif
 
 namespace PE {
 
+namespace {
+
+// Finds the first vertex with the largest projection on dir, four vertices at a time when SSE2 is available.
+inline float supportVertex(Vector3& resultVertex, const Vector3& dir, const std::vector<Vector3>& vertices)
+{
+    int i = 0, index = -1, count = (int)vertices.size();
+    float max = PE_MINNUMBERf, set;
+#if defined(PE_SUPPORT_SSE2)
+    if (count >= 8) {
+        Vector3x4 direction(_mm_set1_ps(dir.x), _mm_set1_ps(dir.y), _mm_set1_ps(dir.z));
+        __m128 maxDots = _mm_set1_ps(PE_MINNUMBERf);
+        __m128i maxIndices = _mm_set1_epi32(-1);
+        __m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i step = _mm_set1_epi32(4);
+        for (; i + 4 <= count; i += 4) {
+            __m128 dots = dot(Vector3x4::load(&vertices[i]), direction);
+            __m128 greater = _mm_cmpgt_ps(dots, maxDots);
+            maxDots = _mm_or_ps(_mm_and_ps(greater, dots), _mm_andnot_ps(greater, maxDots));
+            __m128i greaterIndices = _mm_castps_si128(greater);
+            maxIndices = _mm_or_si128(_mm_and_si128(greaterIndices, indices),
+                                      _mm_andnot_si128(greaterIndices, maxIndices));
+            indices = _mm_add_epi32(indices, step);
+        }
+        alignas(16) float laneDots[4];
+        alignas(16) int laneIndices[4];
+        _mm_store_ps(laneDots, maxDots);
+        _mm_store_si128(reinterpret_cast<__m128i*>(laneIndices), maxIndices);
+        for (int k = 0; k < 4; ++k) {
+            if ((laneIndices[k] >= 0) &&
+                    ((laneDots[k] > max) || ((laneDots[k] == max) && (laneIndices[k] < index)))) {
+                max = laneDots[k];
+                index = laneIndices[k];
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        set = dot(vertices[i], dir);
+        if (set > max) {
+            max = set;
+            index = i;
+        }
+    }
+    if (index >= 0)
+        resultVertex = vertices[index];
+    return max;
+}
+
+} // namespace
+
 Shape::Shape()
 {
     m_type = TypeShape::Undefined;
     m_body = nullptr;
+    m_pool = nullptr;
     m_index = std::numeric_limits<std::size_t>::max();
 }
 
@@ -39,7 +97,7 @@ TypeShape Shape::type() const
 
 int Shape::countVertices() const
 {
-    return (int)m_local_vertices.size();
+    return (int)_localVertices().size();
 }
 
 Bounds Shape::bounds() const
@@ -59,39 +117,44 @@ void Shape::setMaterial(const Material& material)
 
 Bounds Shape::getLocalBounds() const
 {
+    const std::vector<Vector3>& localVertices = _localVertices();
     Bounds bounds;
     bounds.init();
-    for (auto it = m_local_vertices.begin(); it != m_local_vertices.end(); ++it) {
+    for (auto it = localVertices.begin(); it != localVertices.end(); ++it) {
         bounds.min.minAxis(*it);
         bounds.max.maxAxis(*it);
     }
     return bounds;
 }
 
+float Shape::boundingRadius() const
+{
+    const std::vector<Vector3>& localVertices = _localVertices();
+    float maxLengthSquared = 0.0f;
+    for (auto it = localVertices.begin(); it != localVertices.end(); ++it)
+        maxLengthSquared = std::max(maxLengthSquared, it->lengthSquared());
+    return std::sqrt(maxLengthSquared);
+}
+
 float Shape::support(Vector3& resultVertex, const Vector3& dir) const
 {
-    float max = PE_MINNUMBERf, set;
-    for (int i = 0; i < (int)m_global_vertices.size(); ++i) {
-        set = dot(m_global_vertices[i], dir);
-        if (set > max) {
-            max = set;
-            resultVertex = m_global_vertices[i];
-        }
-    }
-    return max;
+    return supportVertex(resultVertex, dir, m_global_vertices);
 }
 
 float Shape::support_local(Vector3& resultVertex, const Vector3& dir) const
 {
-    float max = PE_MINNUMBERf, set;
-    for (int i = 0; i < (int)m_global_vertices.size(); ++i) {
-        set = dot(m_local_vertices[i], dir);
-        if (set > max) {
-            max = set;
-            resultVertex = m_local_vertices[i];
-        }
-    }
-    return max;
+    return supportVertex(resultVertex, dir, _localVertices());
+}
+
+const std::vector<Vector3>& Shape::_localVertices() const
+{
+    return m_local_vertices;
+}
+
+void Shape::_geometryChanged()
+{
+    if (m_body != nullptr)
+        ++m_body->m_transformRevision;
 }
 
 } // namespace PE
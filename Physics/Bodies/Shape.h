@@ -2,6 +2,7 @@
 #define PE_SHAPE_H
 
 #include <vector>
+#include <functional>
 #include "../Settings.h"
 #include "../VectorMath/Vector3.h"
 #include "Material.h"
@@ -51,6 +52,38 @@ struct Bounds
 class PhysicsWorld;
 class Body;
 class CollisionDetected;
+class Shape;
+
+struct ShapePair
+{
+    const Shape* shapeA;
+    const Shape* shapeB;
+
+    ShapePair(const Shape* a, const Shape* b)
+    {
+        if (std::less<const Shape*>()(a, b)) {
+            shapeA = a;
+            shapeB = b;
+        } else {
+            shapeA = b;
+            shapeB = a;
+        }
+    }
+
+    bool operator == (const ShapePair& pair) const
+    {
+        return (shapeA == pair.shapeA) && (shapeB == pair.shapeB);
+    }
+};
+
+struct ShapePairHash
+{
+    std::size_t operator()(const ShapePair& pair) const
+    {
+        std::size_t hashA = std::hash<const Shape*>()(pair.shapeA);
+        return hashA ^ (std::hash<const Shape*>()(pair.shapeB) + 0x9e3779b9 + (hashA << 6) + (hashA >> 2));
+    }
+};
 
 class Shape
 {
@@ -69,7 +102,8 @@ public:
     Material material() const;
     void setMaterial(const Material& material);
 
-    Bounds getLocalBounds() const;
+    virtual Bounds getLocalBounds() const;
+    virtual float boundingRadius() const;
 
     float support(Vector3& resultVertex, const Vector3& dir) const;
     float support_local(Vector3& resultVertex, const Vector3& dir) const;
@@ -80,7 +114,9 @@ public:
 protected:
     friend class Body;
     friend class CollisionDetected;
+    friend class PhysicsWorld;
 
+    PhysicsWorld* m_pool;
     std::size_t m_index;
     TypeShape m_type;
     Material m_material;
@@ -88,6 +124,10 @@ protected:
     Bounds m_bounds;
     std::vector<Vector3> m_local_vertices;
     std::vector<Vector3> m_global_vertices;
+
+    virtual const std::vector<Vector3>& _localVertices() const;
+    // Drops what was cached against the old geometry, like the separation of the shape's pairs.
+    void _geometryChanged();
 };
 
 } // namespace PE
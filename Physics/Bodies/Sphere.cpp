@@ -35,6 +35,7 @@ float Sphere::radius() const
 void Sphere::setRadius(float radius)
 {
     m_radius = radius;
+    _geometryChanged();
 }
 
 Vector3 Sphere::localPosition() const
@@ -45,6 +46,7 @@ Vector3 Sphere::localPosition() const
 void Sphere::setLocalPosition(const Vector3& localPosition)
 {
     m_local_vertices[0] = localPosition;
+    _geometryChanged();
 }
 
 Vector3 Sphere::position() const
@@ -52,6 +54,11 @@ Vector3 Sphere::position() const
     return m_global_vertices[0];
 }
 
+float Sphere::boundingRadius() const
+{
+    return Shape::boundingRadius() + m_radius;
+}
+
 Shape* Sphere::copy() const
 {
     Sphere* sphere = new Sphere();
@@ -64,7 +71,7 @@ Shape* Sphere::copy() const
 
 void Sphere::update()
 {
-    m_global_vertices[0] = m_body->position() + m_body->rotation().vectorRotated(m_local_vertices[0]);
+    m_global_vertices[0] = m_body->position() + m_body->orientation().vectorRotated(m_local_vertices[0]);
     m_bounds.min = m_global_vertices[0] - Vector3(m_radius, m_radius, m_radius);
     m_bounds.max = m_global_vertices[0] + Vector3(m_radius, m_radius, m_radius);
 }
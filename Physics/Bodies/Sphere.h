@@ -22,6 +22,8 @@ public:
     float radius() const;
     void setRadius(float radius);
 
+    float boundingRadius() const override;
+
     Shape* copy() const override;
     void update() override;
 
@@ -12,6 +12,23 @@ CollisionDetected::CollisionDetected():
 {
 }
 
+const SeparationCache& CollisionDetected::separationCache() const
+{
+    return m_separationCache;
+}
+
+SeparationCache& CollisionDetected::separationCache()
+{
+    return m_separationCache;
+}
+
+float CollisionDetected::_separationBound(float distanceSquared)
+{
+    if (distanceSquared <= GJK::EPS)
+        return 0.0f;
+    return (distanceSquared - GJK::EPS) / std::sqrt(distanceSquared);
+}
+
 void CollisionDetected::collision(Sphere* sphereA, Sphere* sphereB, float xdt)
 {
     Vector3 normal = sphereB->position() - sphereA->position();
@@ -25,7 +42,7 @@ void CollisionDetected::collision(Sphere* sphereA, Sphere* sphereB, float xdt)
 		contact.depth = (rSum - dis);
         contact.pointOnBodyA = sphereA->m_global_vertices[0] + (normal * sphereA->radius());
         contact.pointOnBodyB = sphereB->m_global_vertices[0] - (normal * sphereB->radius());
-        int nCM = addContactManifold(sphereB->body(), sphereA->body(), normal,
+        int nCM = addContactManifold(sphereB, sphereA, normal,
                                      sphereA->material().mixed(sphereB->material()));
 		addContact(nCM, contact, xdt);
         compareContacts(nCM);
@@ -52,7 +69,7 @@ void CollisionDetected::collision(Capsule* capsule, Sphere* sphere, float xdt)
             contact.pointOnBodyA -= normal * capsule->radius();
             contact.pointOnBodyB = sphere->m_global_vertices[0] + (normal * sphere->radius());
 			contact.depth = rSum - length;
-            int nCM = addContactManifold(capsule->body(), sphere->body(), normal,
+            int nCM = addContactManifold(capsule, sphere, normal,
                                          capsule->material().mixed(sphere->material()));
 			addContact(nCM, contact, xdt);
             compareContacts(nCM);
@@ -71,7 +88,7 @@ void CollisionDetected::collision(Capsule* capsule, Sphere* sphere, float xdt)
         contact.pointOnBodyA = capsule->m_global_vertices[nS] - (normal * capsule->radius());
         contact.pointOnBodyB = sphere->m_global_vertices[0] + (normal * sphere->radius());
 		contact.depth = rSum - length;
-        int nCM = addContactManifold(capsule->body(), sphere->body(), normal,
+        int nCM = addContactManifold(capsule, sphere, normal,
                                      capsule->material().mixed(sphere->material()));
 		addContact(nCM, contact, xdt);
         compareContacts(nCM);
@@ -87,13 +104,17 @@ void CollisionDetected::collision(Capsule* capsuleA, Capsule* capsuleB, float xd
 {
     //if (!collision(capsuleA->bounds(), capsuleB->bounds()))
     //    return;
+    if (m_separationCache.isSeparated(capsuleA, capsuleB))
+        return;
     float rSum = capsuleA->radius() + capsuleB->radius();
     Vector3 normal;
     ContactPoint contact;
     if (!m_gjk.compute(normal, capsuleA, capsuleB)) {
         contact.depth = normal.lengthSquared();
-        if (contact.depth > (rSum * rSum))
+        if (contact.depth > (rSum * rSum)) {
+            m_separationCache.setSeparation(capsuleA, capsuleB, _separationBound(contact.depth) - rSum);
             return;
+        }
         contact.depth = std::sqrt(contact.depth);
         if (contact.depth <= PE_EPSf)
             return;
@@ -104,7 +125,7 @@ void CollisionDetected::collision(Capsule* capsuleA, Capsule* capsuleB, float xd
         normal = - normal;
         contact.depth = rSum - m_epa.minDepth;
 	}
-    int nCM = addContactManifold(capsuleA->body(), capsuleB->body(), normal,
+    int nCM = addContactManifold(capsuleA, capsuleB, normal,
                                  capsuleA->material().mixed(capsuleB->material()));
     float mS1 = dot(capsuleA->dir(), normal),
           mS2 = dot(capsuleB->dir(), normal);
@@ -281,12 +302,16 @@ void CollisionDetected::collision(Hull* hull, Sphere* sphere, float xdt)
 {
     //if (!collision(hull->bounds(), sphere->bounds()))
     //    return;
-	float depth;
+    if (m_separationCache.isSeparated(hull, sphere))
+        return;
+    float depth;
     Vector3 normal;
     if (!m_gjk.compute(normal, hull, sphere)) {
         depth = normal.lengthSquared();
-        if (depth > (sphere->radius() * sphere->radius()))
+        if (depth > (sphere->radius() * sphere->radius())) {
+            m_separationCache.setSeparation(hull, sphere, _separationBound(depth) - sphere->radius());
             return;
+        }
         depth = std::sqrt(depth);
         if (depth <= PE_EPSf)
             return;
@@ -304,13 +329,13 @@ void CollisionDetected::collision(Hull* hull, Sphere* sphere, float xdt)
     if (bodyA->isDynamic()) {
         contact.pointOnBodyB = sphere->m_global_vertices[0] + (normal * sphere->radius());
 		contact.pointOnBodyA = contact.pointOnBodyB - (normal * depth);
-        nCM = addContactManifold(bodyA, sphere->body(), normal,
+        nCM = addContactManifold(hull, sphere, normal,
                                  hull->material().mixed(sphere->material()));
 		addContact(nCM, contact, xdt);
     } else {
         contact.pointOnBodyA = sphere->m_global_vertices[0] + (normal * sphere->radius());
 		contact.pointOnBodyB = contact.pointOnBodyA - (normal * depth);
-        nCM = addContactManifold(sphere->body(), bodyA, (-normal),
+        nCM = addContactManifold(sphere, hull, (-normal),
                                  hull->material().mixed(sphere->material()));
 		addContact(nCM, contact, xdt);
 	}
@@ -327,7 +352,7 @@ inline bool CollisionDetected::vertexInPolygon(const Vector3& vertex_pos, const
 {
     int j;
 	float dis;
-    for (j = 0; j < (int)polygon.vertices.size() - 1; ++j) {
+    for (j = 0; j < polygon.countVertices - 1; ++j) {
         dis = dot(vertex_pos - vertexBuffer[polygon.vertices[j]],
                 cross((vertexBuffer[polygon.vertices[j + 1]] - vertexBuffer[polygon.vertices[j]]), polygon.normal));
         if (dis > - PE_EPSf)
@@ -346,14 +371,14 @@ bool CollisionDetected::vertexToPolygon(Vector3& result, const Vector3& vertex_p
     int j;
     float dis, minDis = PE_MAXNUMBERf;
     Vector3 dir, point;
-    for (j = 0; j < (int) polygon.vertices.size(); ++j) {
+    for (j = 0; j < polygon.countVertices; ++j) {
         dis = (vertex_pos - vertexBuffer[polygon.vertices[j]]).lengthSquared();
         if (dis < minDis) {
 			minDis = dis;
             result = vertexBuffer[polygon.vertices[j]];
 		}
 	}
-    for (j = 0; j < (int) polygon.vertices.size() - 1; ++j) {
+    for (j = 0; j < polygon.countVertices - 1; ++j) {
         dir = vertexBuffer[polygon.vertices[j + 1]] - vertexBuffer[polygon.vertices[j]];
         dis = dot(vertex_pos - vertexBuffer[polygon.vertices[j]], dir) / dir.lengthSquared();
         if ((dis >= 0.0f) && (dis <= 1.0f)) {
@@ -384,12 +409,16 @@ void CollisionDetected::collision(Hull* hull, Capsule* capsule, float xdt)
 {
     //if (!collision(hull->bounds(), capsule->bounds()))
     //    return;
+    if (m_separationCache.isSeparated(hull, capsule))
+        return;
     Vector3 normal;
     ContactPoint contact;
     if (!m_gjk.compute(normal, hull, capsule)) {
         contact.depth = normal.lengthSquared();
-        if (contact.depth > (capsule->radius() * capsule->radius()))
+        if (contact.depth > (capsule->radius() * capsule->radius())) {
+            m_separationCache.setSeparation(hull, capsule, _separationBound(contact.depth) - capsule->radius());
             return;
+        }
         contact.depth = std::sqrt(contact.depth);
         if (contact.depth <= PE_EPSf)
             return;
@@ -400,30 +429,29 @@ void CollisionDetected::collision(Hull* hull, Capsule* capsule, float xdt)
         contact.depth = capsule->radius() - m_epa.minDepth;
 	}
     Body* hullBody = hull->body();
-    Body* capsuleBody = capsule->body();
     const std::vector<Vector3>& hullVertices = hull->m_global_vertices;
     const std::vector<Vector3>& capsuleVertices = capsule->m_global_vertices;
-    int nCM = addContactManifold(hullBody, capsuleBody, (-normal),
+    int nCM = addContactManifold(hull, capsule, (-normal),
                                  hull->material().mixed(capsule->material()));
-    Vector3 temp = hullBody->rotation().vectorToAxis(normal);
-    const Polygon* polygon = &hull->polygon(0);
-    int i, cP = hull->countPolygons();
-    float dis, maxA = dot(temp, polygon->normal);
+    Vector3 temp = hullBody->orientation().vectorToAxis(normal);
+    int i, indexPolygon = 0, cP = hull->countPolygons();
+    float dis, maxA = dot(temp, hull->polygonNormal(0));
     for(i = 1; i < cP; ++i) {
-        dis = dot(temp, hull->polygon(i).normal);
+        dis = dot(temp, hull->polygonNormal(i));
         if (dis > maxA) {
 			maxA = dis;
-            polygon = &hull->polygon(i);
+            indexPolygon = i;
 		}
 	}
+    Polygon polygon = hull->polygon(indexPolygon);
     if (std::fabs(1.0f - maxA) < PE_EPSf) {
-        normal = hullBody->rotation().vectorRotated(polygon->normal);
+        normal = hullBody->orientation().vectorRotated(polygon.normal);
         int countContacts = 0;
 		float t1, t2;
-        Vector3 pA = hullVertices[polygon->vertices[0]];
+        Vector3 pA = hullVertices[polygon.vertices[0]];
         contact.depth = dot(capsuleVertices[0] - pA, normal);
         if (contact.depth <= capsule->radius()) {
-            if (vertexInPolygon(capsuleVertices[0], hull->m_global_vertices, *polygon)) {
+            if (vertexInPolygon(capsuleVertices[0], hull->m_global_vertices, polygon)) {
                 contact.pointOnBodyA = capsuleVertices[0] - (normal * contact.depth);
                 contact.pointOnBodyB = capsuleVertices[0] - (normal * capsule->radius());
                 contact.depth = capsule->radius() - contact.depth;
@@ -433,7 +461,7 @@ void CollisionDetected::collision(Hull* hull, Capsule* capsule, float xdt)
 		}
         contact.depth = dot(capsuleVertices[1] - pA, normal);
         if (contact.depth <= capsule->radius()) {
-            if (vertexInPolygon(capsuleVertices[1], hullVertices, *polygon)) {
+            if (vertexInPolygon(capsuleVertices[1], hullVertices, polygon)) {
                 contact.pointOnBodyA = capsuleVertices[1] - (normal * contact.depth);
                 contact.pointOnBodyB = capsuleVertices[1] - (normal * capsule->radius());
                 contact.depth = capsule->radius() - contact.depth;
@@ -444,9 +472,9 @@ void CollisionDetected::collision(Hull* hull, Capsule* capsule, float xdt)
         if (countContacts < 2) {
             Vector3 p1 = projectionToPlane_n(normal, pA, capsuleVertices[0]),
                 p2 = projectionToPlane_n(normal, pA, capsuleVertices[1]);
-            for (i = 0; i < (int)polygon->vertices.size() - 1; ++i) {
+            for (i = 0; i < polygon.countVertices - 1; ++i) {
                 if (collisionLinesOnPlane(contact.pointOnBodyA, t1, t2, p1, p2,
-                                          hullVertices[polygon->vertices[i]], hullVertices[polygon->vertices[i+1]], normal))
+                                          hullVertices[polygon.vertices[i]], hullVertices[polygon.vertices[i+1]], normal))
 				{
                     contact.pointOnBodyB = capsuleVertices[0] + ((capsuleVertices[1] - capsuleVertices[0]) * t2);
 					contact.depth = dot(contact.pointOnBodyB - contact.pointOnBodyA, normal);
@@ -461,8 +489,8 @@ void CollisionDetected::collision(Hull* hull, Capsule* capsule, float xdt)
 				}
 			}
             if (countContacts < 2) {
-                if (collisionLinesOnPlane(contact.pointOnBodyA, t1, t2, p1, p2, hullVertices[polygon->vertices[i]],
-                                          hullVertices[polygon->vertices[0]], normal))
+                if (collisionLinesOnPlane(contact.pointOnBodyA, t1, t2, p1, p2, hullVertices[polygon.vertices[i]],
+                                          hullVertices[polygon.vertices[0]], normal))
 				{
                     contact.pointOnBodyB = capsuleVertices[0] + ((capsuleVertices[1] - capsuleVertices[0]) * t2);
 					contact.depth = dot(contact.pointOnBodyB - contact.pointOnBodyA, normal);
@@ -477,19 +505,19 @@ void CollisionDetected::collision(Hull* hull, Capsule* capsule, float xdt)
 		}
     } else {
 		int vP[2];
-        vP[0] = polygon->vertices[0];
+        vP[0] = polygon.vertices[0];
         float maxB = PE_MINNUMBERf;
         maxA = dot(hullVertices[vP[0]], normal);
-        for(i = 1; i < (int)polygon->vertices.size(); ++i) {
-            dis = dot(hullVertices[polygon->vertices[i]], normal);
+        for(i = 1; i < polygon.countVertices; ++i) {
+            dis = dot(hullVertices[polygon.vertices[i]], normal);
             if (dis > maxA) {
 				maxB = maxA;
 				vP[1] = vP[0];
 				maxA = dis;
-                vP[0] = polygon->vertices[i];
+                vP[0] = polygon.vertices[i];
             } else if (dis > maxB) {
 				maxB = dis;
-                vP[1] = polygon->vertices[i];
+                vP[1] = polygon.vertices[i];
 			}
 		}
         Vector3 edge = hullVertices[vP[1]] - hullVertices[vP[0]];
@@ -663,7 +691,8 @@ void CollisionDetected::collision(Capsule* capsule, Hull* hull, float xdt)
 	collision(hull, capsule, xdt);
 }
 
-void CollisionDetected::collisionPolygonToPolygon(int nCM, const Polygon& poligonA, const Vector3& normalA, const Polygon& poligonB, const Vector3& normalB,
+void CollisionDetected::collisionPolygonToPolygon(int nCM, int indexPolygonA, const Polygon& poligonA, const Vector3& normalA,
+                                                  int indexPolygonB, const Polygon& poligonB, const Vector3& normalB,
                                                   const Vector3& pA, const Vector3& pB,
                                                   const std::vector<Vector3>& vertexBufferA, const std::vector<Vector3>& vertexBufferB,
                                                   const Vector3& normal, float xdt)
@@ -672,14 +701,14 @@ void CollisionDetected::collisionPolygonToPolygon(int nCM, const Polygon& poligo
 	int i, j, previ, indexVertex0_A, indexVertex1_A, indexVertex0_B, indexVertex1_B;
 	float t1, t2, depth;
     Vector3 temp, temp1;
-    previ = (int)poligonA.vertices.size() - 1;
+    previ = poligonA.countVertices - 1;
     indexVertex0_A = poligonA.vertices[previ];
     Vector3 vp, vn = projectionToPlane_n(normal, pB, vertexBufferA[indexVertex0_A]);
-    for (i = 0; i < (int)poligonA.vertices.size(); ++i) {
+    for (i = 0; i < poligonA.countVertices; ++i) {
 		vp = vn;
         indexVertex1_A = poligonA.vertices[i];
         vn = projectionToPlane_n(normal, pB, vertexBufferA[indexVertex1_A]);
-        for (j = 0; j < (int)poligonB.vertices.size() - 1; ++j) {
+        for (j = 0; j < poligonB.countVertices - 1; ++j) {
             indexVertex0_B = poligonB.vertices[j];
             indexVertex1_B = poligonB.vertices[j+1];
             if (collisionLinesOnPlane(temp, t1, t2, vp, vn, vertexBufferB[indexVertex0_B], vertexBufferB[indexVertex1_B], normal)) {
@@ -687,7 +716,8 @@ void CollisionDetected::collisionPolygonToPolygon(int nCM, const Polygon& poligo
 				depth = dot(temp1 - pB, normalB);
                 if (depth <= 0.0f) {
                     depth = std::fabs(dot(normalB * depth, normal));
-					addTempContactPoint(temp1, temp, depth);
+                    addTempContactPoint(temp1, temp, depth, makeFeature(FeatureType::Edge, indexVertex0_A,
+                                                                        FeatureType::Edge, indexVertex0_B));
 				}
 			}
 		}
@@ -698,24 +728,26 @@ void CollisionDetected::collisionPolygonToPolygon(int nCM, const Polygon& poligo
 			depth = dot(temp1 - pB, normalB);
             if (depth <= 0.0f) {
                 depth = std::fabs(dot(normalB * depth, normal));
-				addTempContactPoint(temp1, temp, depth);
+                addTempContactPoint(temp1, temp, depth, makeFeature(FeatureType::Edge, indexVertex0_A,
+                                                                    FeatureType::Edge, indexVertex0_B));
 			}
 		}
 		indexVertex0_A = indexVertex1_A;
 		previ = i;
 	}
-    for (i = 0; i < (int)poligonA.vertices.size(); ++i) {
+    for (i = 0; i < poligonA.countVertices; ++i) {
         indexVertex0_A = poligonA.vertices[i];
 		depth = dot(vertexBufferA[indexVertex0_A] - pB, normalB);
         if (depth <= 0.0f) {
             if (vertexInPolygon(vertexBufferA[indexVertex0_A], vertexBufferB, poligonB)) {
 				temp = vertexBufferA[indexVertex0_A] - (normalB * depth);
                 depth = std::fabs(dot(normalB * depth, normal));
-				addTempContactPoint(vertexBufferA[indexVertex0_A], temp, depth);
+                addTempContactPoint(vertexBufferA[indexVertex0_A], temp, depth,
+                                    makeFeature(FeatureType::Vertex, indexVertex0_A, FeatureType::Face, indexPolygonB));
 			}
         }
 	}
-    for (i = 0; i < (int)poligonB.vertices.size(); ++i)
+    for (i = 0; i < poligonB.countVertices; ++i)
 	{
         indexVertex0_B = poligonB.vertices[i];
 		depth = dot(vertexBufferB[indexVertex0_B] - pA, normalA);
@@ -723,7 +755,8 @@ void CollisionDetected::collisionPolygonToPolygon(int nCM, const Polygon& poligo
             if (vertexInPolygon(vertexBufferB[indexVertex0_B], vertexBufferA, poligonA)) {
 				temp = vertexBufferB[indexVertex0_B] - (normalA * depth);
                 depth = std::fabs(dot(normalA * depth, normal));
-				addTempContactPoint(temp, vertexBufferB[indexVertex0_B], depth);
+                addTempContactPoint(temp, vertexBufferB[indexVertex0_B], depth,
+                                    makeFeature(FeatureType::Face, indexPolygonA, FeatureType::Vertex, indexVertex0_B));
 			}
         }
 	}
@@ -737,33 +770,34 @@ void CollisionDetected::generateContactManifold(Hull* hullA, Hull* hullB, const
     Body* bodyB = hullB->body();
     const std::vector<Vector3>& vertexBufferA = hullA->m_global_vertices;
     const std::vector<Vector3>& vertexBufferB = hullB->m_global_vertices;
-    const RotationMatrix& rotationA = bodyA->rotation();
-    const RotationMatrix& rotationB = bodyB->rotation();
-    Vector3 tempnormal = rotationA.vectorToAxis(normal);
-    const Polygon* polygonA = &hullA->polygon(0);
-    int i, cP = hullA->countPolygons();
-    float dis, maxA = dot(tempnormal, polygonA->normal);
+    const Quaternion& orientationA = bodyA->orientation();
+    const Quaternion& orientationB = bodyB->orientation();
+    Vector3 tempnormal = orientationA.vectorToAxis(normal);
+    int i, indexPolygonA = 0, cP = hullA->countPolygons();
+    float dis, maxA = dot(tempnormal, hullA->polygonNormal(0));
     for(i = 1; i < cP; ++i) {
-        dis = dot(tempnormal, hullA->polygon(i).normal);
+        dis = dot(tempnormal, hullA->polygonNormal(i));
         if (dis > maxA) {
 			maxA = dis;
-            polygonA = &hullA->polygon(i);
+            indexPolygonA = i;
 		}
 	}
-    tempnormal = - rotationB.vectorToAxis(normal);
-    const Polygon* polygonB = &hullB->polygon(0);
+    tempnormal = - orientationB.vectorToAxis(normal);
+    int indexPolygonB = 0;
     cP = hullB->countPolygons();
-    float maxB = dot(tempnormal, polygonB->normal);
+    float maxB = dot(tempnormal, hullB->polygonNormal(0));
     for (i = 1; i < cP; ++i) {
-        dis = dot(tempnormal, hullB->polygon(i).normal);
+        dis = dot(tempnormal, hullB->polygonNormal(i));
         if (dis > maxB) {
 			maxB = dis;
-            polygonB = &hullB->polygon(i);
+            indexPolygonB = i;
 		}
 	}
-    Vector3 normalA = rotationA.vectorRotated(polygonA->normal);
-    Vector3 normalB = rotationB.vectorRotated(polygonB->normal);
-    int nCM = addContactManifold(bodyA, bodyB, - normal,
+    Polygon polygonA = hullA->polygon(indexPolygonA);
+    Polygon polygonB = hullB->polygon(indexPolygonB);
+    Vector3 normalA = orientationA.vectorRotated(polygonA.normal);
+    Vector3 normalB = orientationB.vectorRotated(polygonB.normal);
+    int nCM = addContactManifold(hullA, hullB, - normal,
                                  hullA->material().mixed(hullB->material()));
     int indexVertex;
     /*Vector3 pdir = cross(normalA, normalB);
@@ -778,8 +812,8 @@ void CollisionDetected::generateContactManifold(Hull* hullA, Hull* hullB, const
 	}else{*/
         Vector3 smaxA, smaxB;
         float max = PE_MINNUMBERf;
-        for (i = 0; i < (int)polygonA->vertices.size(); ++i) {
-            indexVertex = polygonA->vertices[i];
+        for (i = 0; i < polygonA.countVertices; ++i) {
+            indexVertex = polygonA.vertices[i];
 			dis = dot(normal, vertexBufferA[indexVertex]);
             if (dis > max) {
 				max = dis;
@@ -788,8 +822,8 @@ void CollisionDetected::generateContactManifold(Hull* hullA, Hull* hullB, const
 		}
         max = PE_MINNUMBERf;
 		tempnormal = - normal;
-        for (i = 0; i < (int)polygonB->vertices.size(); ++i) {
-            indexVertex = polygonB->vertices[i];
+        for (i = 0; i < polygonB.countVertices; ++i) {
+            indexVertex = polygonB.vertices[i];
 			dis = dot(tempnormal, vertexBufferB[indexVertex]);
 			if (dis > max)
 			{
@@ -798,7 +832,8 @@ void CollisionDetected::generateContactManifold(Hull* hullA, Hull* hullB, const
 			}
 		}
 		//if (abs(1.0f - maxA) < abs(1.0f - maxB))
-            collisionPolygonToPolygon(nCM, *polygonA, normalA, *polygonB, normalB, smaxA, smaxB, vertexBufferA, vertexBufferB, normal, xdt);
+            collisionPolygonToPolygon(nCM, indexPolygonA, polygonA, normalA, indexPolygonB, polygonB, normalB,
+                                      smaxA, smaxB, vertexBufferA, vertexBufferB, normal, xdt);
 		//else
 		//	collisionPoligonToPoligon(poligonB, normalB, poligonA, normalA, smaxB, smaxA, -normal, xdt);
 	//}
@@ -809,10 +844,14 @@ void CollisionDetected::collision(Hull* hullA, Hull* hullB, float xdt)
 {
     //if (!collision(hullA->bounds(), hullB->bounds()))
     //    return;
+    if (m_separationCache.isSeparated(hullA, hullB))
+        return;
     Vector3 normal;
     if (m_gjk.compute(normal, hullA, hullB)) {
         m_epa.compute(normal, hullA, hullB, m_gjk.getSimplex(), m_gjk.getNSimplex());
         generateContactManifold(hullA, hullB, normal, xdt);
+    } else {
+        m_separationCache.setSeparation(hullA, hullB, _separationBound(normal.lengthSquared()));
     }
 }
 
@@ -8,6 +8,7 @@
 #include "../Dynamic/ContactsContainer.h"
 #include "GJK.h"
 #include "EPA.h"
+#include "SeparationCache.h"
 
 namespace PE {
 
@@ -17,6 +18,9 @@ class CollisionDetected:
 public:
     CollisionDetected();
 
+    const SeparationCache& separationCache() const;
+    SeparationCache& separationCache();
+
     void collision(Sphere* sphereA, Sphere* sphereB, float xdt);
     void collision(Capsule* capsule, Sphere* sphere, float xdt);
     void collision(Sphere* sphere, Capsule* capsule, float xdt);
@@ -27,8 +31,9 @@ public:
     void collision(Capsule* capsule, Hull* hull, float xdt);
     bool vertexInPolygon(const Vector3& vertex_pos, const std::vector<Vector3>& vertexBuffer, const Polygon& polygon) const;
     bool vertexToPolygon(Vector3& result, const Vector3& vertex_pos, const std::vector<Vector3>& vertexBuffer, const Polygon& polygon) const;
-    void collisionPolygonToPolygon(int nCM, const Polygon& poligonA, const Vector3& normalA,
-                                   const Polygon& poligonB, const Vector3& normalB, const Vector3& pA, const Vector3& pB,
+    void collisionPolygonToPolygon(int nCM, int indexPolygonA, const Polygon& poligonA, const Vector3& normalA,
+                                   int indexPolygonB, const Polygon& poligonB, const Vector3& normalB,
+                                   const Vector3& pA, const Vector3& pB,
                                    const std::vector<Vector3>& vertexBufferA, const std::vector<Vector3>& vertexBufferB,
                                    const Vector3& normal, float xdt);
     void generateContactManifold(Hull* hullA, Hull* hullB, const Vector3& normal, float xdt);
@@ -37,6 +42,9 @@ public:
 private:
     GJK m_gjk;
     EPA m_epa;
+    SeparationCache m_separationCache;
+
+    static float _separationBound(float distanceSquared);
 };
 
 } // namespace PE
@@ -0,0 +1,108 @@
+#include "SeparationCache.h"
+#include "../Bodies/Body.h"
+
+namespace PE {
+
+SeparationCache::SeparationCache()
+{
+    m_enabled = true;
+    m_step = 0;
+    m_countSkipped = 0;
+}
+
+bool SeparationCache::isEnabled() const
+{
+    return m_enabled;
+}
+
+void SeparationCache::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!m_enabled)
+        clear();
+}
+
+void SeparationCache::nextStep()
+{
+    ++m_step;
+    m_countSkipped = 0;
+    m_prev_indices.swap(m_indices);
+    m_prev_entries.swap(m_entries);
+    m_indices.clear();
+    m_entries.resize(0);
+}
+
+void SeparationCache::clear()
+{
+    m_prev_indices.clear();
+    m_indices.clear();
+    m_prev_entries.resize(0);
+    m_entries.resize(0);
+    m_countSkipped = 0;
+}
+
+void SeparationCache::removeShape(const Shape* shape)
+{
+    m_prev_indices.remove(shape);
+    m_indices.remove(shape);
+}
+
+bool SeparationCache::isSeparated(const Shape* shapeA, const Shape* shapeB)
+{
+    if (!m_enabled)
+        return false;
+    ShapePair pair(shapeA, shapeB);
+    int index = m_prev_indices.find(pair);
+    if ((index < 0) || (m_indices.find(pair) >= 0))
+        return false;
+    const Entry& entry = m_prev_entries[index];
+    const Body* bodyA = pair.shapeA->body();
+    const Body* bodyB = pair.shapeB->body();
+    if ((entry.revisionA != bodyA->m_transformRevision) ||
+            (entry.revisionB != bodyB->m_transformRevision))
+        return false;
+    float distance = entry.distance - (bodyA->motionBound() + bodyB->motionBound());
+    if (distance <= 0.0f)
+        return false;
+    Entry& nextEntry = _entry(pair);
+    nextEntry = entry;
+    nextEntry.distance = distance;
+    nextEntry.step = m_step;
+    ++m_countSkipped;
+    return true;
+}
+
+void SeparationCache::setSeparation(const Shape* shapeA, const Shape* shapeB, float distance)
+{
+    if (!m_enabled || (distance <= 0.0f))
+        return;
+    ShapePair pair(shapeA, shapeB);
+    Entry& entry = _entry(pair);
+    entry.distance = distance;
+    entry.revisionA = pair.shapeA->body()->m_transformRevision;
+    entry.revisionB = pair.shapeB->body()->m_transformRevision;
+    entry.step = m_step;
+}
+
+std::size_t SeparationCache::countEntries() const
+{
+    return m_entries.size();
+}
+
+int SeparationCache::countSkipped() const
+{
+    return m_countSkipped;
+}
+
+SeparationCache::Entry& SeparationCache::_entry(const ShapePair& pair)
+{
+    int index = m_indices.find(pair);
+    if (index < 0) {
+        index = (int)m_entries.size();
+        m_indices.insert(pair, index);
+        m_entries.emplace_back();
+    }
+    return m_entries[index];
+}
+
+} // namespace PE
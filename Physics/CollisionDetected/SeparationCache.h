@@ -0,0 +1,53 @@
+#ifndef PE_SEPARATIONCACHE_H
+#define PE_SEPARATIONCACHE_H
+
+#include <vector>
+#include "../Bodies/Shape.h"
+#include "../Dynamic/ShapePairMap.h"
+
+namespace PE {
+
+class SeparationCache
+{
+public:
+    SeparationCache();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    void nextStep();
+    void clear();
+    // Forgets the pairs of a shape leaving its body, a new shape may get the same address.
+    void removeShape(const Shape* shape);
+
+    bool isSeparated(const Shape* shapeA, const Shape* shapeB);
+    void setSeparation(const Shape* shapeA, const Shape* shapeB, float distance);
+
+    std::size_t countEntries() const;
+    int countSkipped() const;
+
+private:
+    struct Entry
+    {
+        float distance;
+        unsigned int revisionA;
+        unsigned int revisionB;
+        int step;
+    };
+
+    bool m_enabled;
+    int m_step;
+    int m_countSkipped;
+    // Entries of the previous step are read, entries of the current step are written, the buffers are
+    // swapped on the next step and keep their memory.
+    ShapePairMap m_prev_indices;
+    ShapePairMap m_indices;
+    std::vector<Entry> m_prev_entries;
+    std::vector<Entry> m_entries;
+
+    Entry& _entry(const ShapePair& pair);
+};
+
+} // namespace PE
+
+#endif // PE_SEPARATIONCACHE_H
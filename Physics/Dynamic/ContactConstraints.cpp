@@ -0,0 +1,60 @@
+#include "ContactConstraints.h"
+
+namespace PE {
+
+ContactConstraints::ContactConstraints()
+{
+    m_count = 0;
+}
+
+std::size_t ContactConstraints::count() const
+{
+    return m_count;
+}
+
+void ContactConstraints::resize(std::size_t count)
+{
+    m_count = count;
+    if (m_count <= manifold.size())
+        return;
+    manifold.resize(m_count);
+    point.resize(m_count);
+    bodyA.resize(m_count);
+    bodyB.resize(m_count);
+    normal.resize(m_count);
+    binormal.resize(m_count);
+    rnA.resize(m_count);
+    rbA.resize(m_count);
+    rnB.resize(m_count);
+    rbB.resize(m_count);
+    invInertiaRnA.resize(m_count);
+    invInertiaRbA.resize(m_count);
+    invInertiaRnB.resize(m_count);
+    invInertiaRbB.resize(m_count);
+    e.resize(m_count);
+    mu.resize(m_count);
+    depthA.resize(m_count);
+    depthB.resize(m_count);
+    kNormal.resize(m_count);
+    kBinormal.resize(m_count);
+    kPseudo.resize(m_count);
+    impulse.resize(m_count);
+    impulseFriction.resize(m_count);
+    pseudoImpulse.resize(m_count);
+}
+
+void ContactConstraints::setEmpty(std::size_t i)
+{
+    manifold[i] = -1;
+    point[i] = 0;
+    bodyA[i] = bodyB[i] = 0;
+    normal[i] = binormal[i] = Vector3(0.0f, 0.0f, 0.0f);
+    rnA[i] = rbA[i] = rnB[i] = rbB[i] = Vector3(0.0f, 0.0f, 0.0f);
+    invInertiaRnA[i] = invInertiaRbA[i] = invInertiaRnB[i] = invInertiaRbB[i] = Vector3(0.0f, 0.0f, 0.0f);
+    e[i] = mu[i] = 0.0f;
+    depthA[i] = depthB[i] = 0.0f;
+    kNormal[i] = kBinormal[i] = kPseudo[i] = 1.0f;
+    impulse[i] = impulseFriction[i] = pseudoImpulse[i] = 0.0f;
+}
+
+} // namespace PE
@@ -0,0 +1,118 @@
+#ifndef PE_CONTACTCONSTRAINTS_H
+#define PE_CONTACTCONSTRAINTS_H
+
+#include <vector>
+#include <cstdint>
+#include "../Settings.h"
+#include "../VectorMath/Vector3.h"
+#include "../VectorMath/Matrix3.h"
+#include "../Bodies/Body.h"
+#include "../Memory/ScratchArena.h"
+
+namespace PE {
+
+struct SolverBody
+{
+    Vector3 velocity;
+    Vector3 angularVelocity;
+    Vector3 pseudoVelocity;
+    Vector3 pseudoAngularVelocity;
+    float invMass;
+    float pseudoInvMass;
+#if (PE_BodyInertia == 3)
+    Matrix3 invInertia;
+#else
+    float invInertia;
+#endif
+    Body* body;
+
+    Vector3 invInertiaMul(const Vector3& v) const
+    {
+#if (PE_BodyInertia == 3)
+        return invInertia * v;
+#else
+        return v * invInertia;
+#endif
+    }
+
+    // invInertiaRn is the world inverse inertia applied to the lever arm, cached per constraint.
+    void applyImpulse(const Vector3& normal, const Vector3& invInertiaRn, float impulse)
+    {
+        velocity += normal * (invMass * impulse);
+        angularVelocity += invInertiaRn * impulse;
+    }
+
+    void applyPseudoImpulse(const Vector3& normal, const Vector3& invInertiaRn, float pseudoImpulse)
+    {
+        pseudoVelocity += normal * (pseudoInvMass * pseudoImpulse);
+        pseudoAngularVelocity += invInertiaRn * pseudoImpulse;
+    }
+};
+
+class ContactConstraints
+{
+public:
+    ContactConstraints();
+
+    std::size_t count() const;
+    void resize(std::size_t count);
+    void setEmpty(std::size_t i);
+
+    std::vector<int> manifold;
+    std::vector<int> point;
+    std::vector<std::uint32_t> bodyA;
+    std::vector<std::uint32_t> bodyB;
+    std::vector<Vector3> normal;
+    std::vector<Vector3> binormal;
+    std::vector<Vector3> rnA;
+    std::vector<Vector3> rbA;
+    std::vector<Vector3> rnB;
+    std::vector<Vector3> rbB;
+    std::vector<Vector3> invInertiaRnA;
+    std::vector<Vector3> invInertiaRbA;
+    std::vector<Vector3> invInertiaRnB;
+    std::vector<Vector3> invInertiaRbB;
+    std::vector<float> e;
+    std::vector<float> mu;
+    std::vector<float> depthA;
+    std::vector<float> depthB;
+    std::vector<float> kNormal;
+    std::vector<float> kBinormal;
+    std::vector<float> kPseudo;
+    std::vector<float> impulse;
+    std::vector<float> impulseFriction;
+    std::vector<float> pseudoImpulse;
+
+private:
+    std::size_t m_count;
+};
+
+struct SolverContext
+{
+    ContactConstraints constraints;
+    std::vector<SolverBody> solverBodies;
+    std::vector<std::size_t> constraintSlots;
+    std::vector<std::size_t> batchSizes;
+    std::vector<std::size_t> bodyBatches;
+    std::size_t firstOpenBatch;
+    std::vector<std::uint64_t> bodyColors;
+    std::vector<std::uint32_t> manifoldColors;
+    std::vector<std::size_t> manifoldRows;
+    std::vector<std::size_t> coloredManifolds;
+    std::vector<std::size_t> colorGroups;
+    std::vector<std::size_t> groupBatches;
+    std::vector<std::size_t> graphContactManifolds;
+    std::vector<Body*> graphBodies;
+    std::size_t countStaticContacts;
+    std::vector<float> bodyCountRows;
+    std::vector<float> rowScale;
+    std::vector<float> rowImpulse;
+    std::vector<float> rowImpulseFriction;
+    std::vector<float> threadResiduals;
+    // Temporary buffers of the thread using the context.
+    ScratchArena scratch;
+};
+
+} // namespace PE
+
+#endif // PE_CONTACTCONSTRAINTS_H
@@ -1,6 +1,7 @@
 #ifndef PE_CONTACT_H
 #define PE_CONTACT_H
 
+#include <cstdint>
 #include "../VectorMath/Vector3.h"
 #include "../Settings.h"
 #include "../Bodies/Body.h"
@@ -10,12 +11,32 @@ namespace PE {
 class ContactTypes
 {
 public:
+    enum class FeatureType: std::uint32_t
+    {
+        Point,
+        Vertex,
+        Edge,
+        Face
+    };
+
+    static std::uint32_t makeFeature(FeatureType typeA, int indexA, FeatureType typeB, int indexB)
+    {
+        return (((static_cast<std::uint32_t>(typeA) << 14) | (indexA & 0x3FFF)) << 16) |
+                (static_cast<std::uint32_t>(typeB) << 14) | (indexB & 0x3FFF);
+    }
+
+    static std::uint32_t swappedFeature(std::uint32_t feature)
+    {
+        return (feature >> 16) | (feature << 16);
+    }
+
     struct ContactPoint
 	{
         Vector3 pointOnBodyA;
         Vector3 pointOnBodyB;
         Vector3 point;
 		float depth;
+        std::uint32_t feature;
     };
 
     struct R_ContactPoint
@@ -23,11 +44,13 @@ public:
         Vector3 r;
         Vector3 rn;
         Vector3 rb;
+        Vector3 anchor;
     };
 
     struct InfoPointOnCM
 	{
         Vector3 binormal;
+        float depth;
 		float depthA;
 		float depthB;
 		float impulse;
@@ -36,6 +59,17 @@ public:
 		float kNormal;
 		float kBinormal;
 		float kPseudo;
+        std::uint32_t feature;
+    };
+
+    struct Island
+    {
+        std::size_t firstBody;
+        std::size_t countBodies;
+        std::size_t firstManifold;
+        std::size_t countManifolds;
+        int countIterations;
+        int countSplitImpulsesIterations;
     };
 
     struct ContactManifold
@@ -43,6 +77,8 @@ public:
 		bool solved;
         Body* bodyA;
         Body* bodyB;
+        const Shape* shapeA;
+        const Shape* shapeB;
         Vector3 normal;
         InfoPointOnCM infoPoint[PE_MaxCountContactManifoldPoints];
         R_ContactPoint pointA[PE_MaxCountContactManifoldPoints];
@@ -8,6 +8,7 @@ ContactsContainer::ContactsContainer()
     m_ERP_a = 0.15f;
     m_ERP_b = 0.3f;
     m_countUsedPrevContacts = m_countNotUsedPrevContacts = 0;
+    m_countContactManifolds = 0;
 }
 
 void ContactsContainer::setERP(float a, float b)
@@ -21,22 +22,23 @@ void ContactsContainer::clearCMPoints()
     m_countCMPoints = 0;
 }
 
-int ContactsContainer::addContactManifold(Body* bodyA, Body* bodyB, const Vector3& normal, const Material& material)
+int ContactsContainer::addContactManifold(Shape* shapeA, Shape* shapeB, const Vector3& normal, const Material& material)
 {
-    m_contactManifolds.resize(m_contactManifolds.size() + 1);
-    int index = (int)m_contactManifolds.size() - 1;
+    if (m_countContactManifolds == m_contactManifolds.size())
+        m_contactManifolds.resize(m_countContactManifolds + 1);
+    int index = (int)m_countContactManifolds;
     ContactManifold& cm = m_contactManifolds[index];
     cm.solved = false;
-    cm.bodyA = bodyA;
-    cm.bodyB = bodyB;
+    cm.bodyA = shapeA->body();
+    cm.bodyB = shapeB->body();
+    cm.shapeA = shapeA;
+    cm.shapeB = shapeB;
     cm.e = 1.0f + material.e();
     cm.mu = material.mu();
     cm.normal = normal;
     //if (sd) --cm.normal;
-    cm.notStatB = bodyB->isDynamic();
+    cm.notStatB = cm.bodyB->isDynamic();
     cm.countPoints = 0;
-    if (cm.notStatB)
-        cm.bodyA->_mergeCollisionGroupAndAwake(cm.bodyB);
     return index;
 }
 
@@ -80,9 +82,17 @@ void ContactsContainer::solveBinormalOnCM_statB(int nCM, int nPoint)
 }
 
 void ContactsContainer::addContact(int nCM, ContactPoint& contactPoint, float xdt)
+{
+    int nPoint = m_contactManifolds[nCM].countPoints;
+    contactPoint.feature = makeFeature(FeatureType::Point, nPoint, FeatureType::Point, nPoint);
+    addFeatureContact(nCM, contactPoint, xdt);
+}
+
+void ContactsContainer::addFeatureContact(int nCM, const ContactPoint& contactPoint, float xdt)
 {
     ContactManifold& cm = m_contactManifolds[nCM];
     int nPoint = cm.countPoints;
+    cm.infoPoint[nPoint].feature = contactPoint.feature;
 	//contactPoint.pointOnBodyA = contactPoint.point;
 	//contactPoint.pointOnBodyB = contactPoint.point;
     cm.pointA[nPoint].r = contactPoint.pointOnBodyA - cm.bodyA->position();
@@ -91,15 +101,17 @@ void ContactsContainer::addContact(int nCM, ContactPoint& contactPoint, float xd
         cm.pointB[nPoint].r = contactPoint.pointOnBodyB - cm.bodyB->position();
         cm.pointB[nPoint].rn = cross(cm.pointB[nPoint].r, cm.normal);
         computeBinormalOnCM_notStatB(nCM, nPoint);
+        _setContactAnchors(cm, nPoint, contactPoint.pointOnBodyA, contactPoint.pointOnBodyB, contactPoint.depth);
     } else {
 		solveBinormalOnCM_statB(nCM, nPoint);
+        _setContactAnchors(cm, nPoint, contactPoint.pointOnBodyA, contactPoint.pointOnBodyA, contactPoint.depth);
     }
-    contactPoint.depth -= PE_MAIN_DEPTH;
-	/*if (contactPoint.depth > 0.0f)
+    float depth = contactPoint.depth - PE_MAIN_DEPTH;
+	/*if (depth > 0.0f)
 	{*/
-		contactPoint.depth *= xdt;
-        cm.infoPoint[nPoint].depthA = contactPoint.depth * m_ERP_a;
-        cm.infoPoint[nPoint].depthB = contactPoint.depth * m_ERP_b;
+		depth *= xdt;
+        cm.infoPoint[nPoint].depthA = depth * m_ERP_a;
+        cm.infoPoint[nPoint].depthB = depth * m_ERP_b;
     /*} else {
         cm.infoPoint[nPoint].depthA = 0.0f;
         cm.infoPoint[nPoint].depthB = 0.0f;
@@ -112,9 +124,11 @@ void ContactsContainer::addContact_static(int nCM, const Vector3& contactPoint,
     ContactManifold& cm = m_contactManifolds[nCM];
     //cm.notStatB = false;
     int nPoint = cm.countPoints;
+    cm.infoPoint[nPoint].feature = makeFeature(FeatureType::Point, nPoint, FeatureType::Point, nPoint);
     cm.pointA[nPoint].r = contactPoint - cm.bodyA->position();
     cm.pointA[nPoint].rn = cross(cm.pointA[nPoint].r, cm.normal);
 	solveBinormalOnCM_statB(nCM, nPoint);
+    _setContactAnchors(cm, nPoint, contactPoint, contactPoint, depth);
     depth -= PE_MAIN_DEPTH;
     //if (contactPoint.depth > 0.0f) {
 		depth *= xdt;
@@ -127,31 +141,33 @@ void ContactsContainer::addContact_static(int nCM, const Vector3& contactPoint,
     ++cm.countPoints;
 }
 
-void ContactsContainer::addTempContactPoint(const Vector3& pointOnBodyA, const Vector3& pointOnBodyB, float depth)
+void ContactsContainer::addTempContactPoint(const Vector3& pointOnBodyA, const Vector3& pointOnBodyB, float depth,
+                                            std::uint32_t feature)
 {
     m_tempCMPoints[m_countCMPoints].pointOnBodyA = pointOnBodyA;
     m_tempCMPoints[m_countCMPoints].pointOnBodyB = pointOnBodyB;
     m_tempCMPoints[m_countCMPoints].point = (pointOnBodyA + pointOnBodyB) * 0.5f;
     m_tempCMPoints[m_countCMPoints].depth = depth;
+    m_tempCMPoints[m_countCMPoints].feature = feature;
     ++m_countCMPoints;
 }
 
-void ContactsContainer::addTempContactPoint_static(const Vector3& pointOnBodyA, float depth)//static
+void ContactsContainer::addTempContactPoint_static(const Vector3& pointOnBodyA, float depth, std::uint32_t feature)//static
 {
     m_tempCMPoints[m_countCMPoints].pointOnBodyA = pointOnBodyA;
     m_tempCMPoints[m_countCMPoints].point = pointOnBodyA;
     m_tempCMPoints[m_countCMPoints].depth = depth;
+    m_tempCMPoints[m_countCMPoints].feature = feature;
     ++m_countCMPoints;
 }
 
 bool ContactsContainer::optimizeContactPoints(int nCM, const Vector3& normal, float xdt)
 {
     if (m_countCMPoints == 0) {
-        m_contactManifolds.resize(m_contactManifolds.size() - 1);
 		return false;
     } else if (m_countCMPoints < 5) {
         for (int k = 0; k < m_countCMPoints; ++k)
-            addContact(nCM, m_tempCMPoints[k], xdt);
+            addFeatureContact(nCM, m_tempCMPoints[k], xdt);
 		return true;
 	}
     Vector3 normalX, normalY;
@@ -189,7 +205,7 @@ bool ContactsContainer::optimizeContactPoints(int nCM, const Vector3& normal, fl
 			}
 		}
         if (b)
-            addContact(nCM, (*m_contacts[i]), xdt);
+            addFeatureContact(nCM, (*m_contacts[i]), xdt);
 	}
 	return true;
 }
@@ -197,135 +213,137 @@ bool ContactsContainer::optimizeContactPoints(int nCM, const Vector3& normal, fl
 void ContactsContainer::compareContacts(int nCM)
 {
     ContactManifold& cm = m_contactManifolds[nCM];
-	int i, j, prevCM = -1;
-	bool flag, inv;
-    Vector3 sumImpulseL, sumImpulseA;
-    Body* bodyA = cm.bodyA;
-    Body* bodyB = cm.bodyB;
-    if (bodyB->isStatic()) {
+    if (cm.countPoints == 0)
+        return;
+    ++m_countContactManifolds;
+	int i, j;
+    if (cm.bodyB->isStatic()) {
         cm.notStatB = false;
-    } else if (bodyA->isStatic()) {
-        cm.bodyA = bodyB;
-        bodyB = cm.bodyB = bodyA;
-        bodyA = cm.bodyB;
-        R_ContactPoint t;
-        for (int i = 0; i < cm.countPoints; ++i) {
-            t = cm.pointA[i];
-            cm.pointA[i] = cm.pointB[i];
-            cm.pointB[i] = t;
-            cm.pointA[i].rn = - cm.pointA[i].rn;
-            cm.pointB[i].rn = - cm.pointB[i].rn;
-            cm.pointA[i].rb = - cm.pointA[i].rb;
-            cm.pointB[i].rb = - cm.pointB[i].rb;
-		}
-        cm.normal = - cm.normal;
+    } else if (cm.bodyA->isStatic()) {
+        _swapBodies(cm);
         cm.notStatB = false;
     } else {
         cm.notStatB = true;
     }
-    bodyA->addContact(nCM);
-	bodyB->addContact(nCM);
-    for (i = 0; i < (int)bodyA->m_prev_contacts.size(); ++i) {
-        if (m_prev_contactManifolds[bodyA->m_prev_contacts[i]].bodyB == bodyB) {
-            prevCM = bodyA->m_prev_contacts[i];
-			inv = false;
-			break;
-        } else if (m_prev_contactManifolds[bodyA->m_prev_contacts[i]].bodyA == bodyB) {
-            prevCM = bodyA->m_prev_contacts[i];
-			inv = true;
-			break;
-		}
-	}
-    if ((prevCM >= 0)) {// && (bWS)
-        ContactManifold& prev_cm = m_prev_contactManifolds[prevCM];
-        if (inv) {
-            for (i = 0; i < cm.countPoints; ++i) {
-				flag = true;
-                for (j = 0; j < prev_cm.countPoints; ++j) {
-                    if ((cm.pointA[i].r - prev_cm.pointB[j].r).inBound(PE_EPS_forContact)) {
-                        //--cm.infoPoint[i].binormal;
-                        cm.infoPoint[i].impulse = prev_cm.infoPoint[j].impulse;
-                        cm.infoPoint[i].impulseFriction = - prev_cm.infoPoint[j].impulseFriction;
-                        cm.infoPoint[i].pseudoImpulse = prev_cm.infoPoint[j].pseudoImpulse;
-                        sumImpulseL = (cm.normal * cm.infoPoint[i].impulse) + (cm.infoPoint[i].binormal * cm.infoPoint[i].impulseFriction);
-						bodyA->applyLinearImpulse(sumImpulseL);
-                        sumImpulseA = (cm.pointA[i].rn * cm.infoPoint[i].impulse) + (cm.pointA[i].rb * cm.infoPoint[i].impulseFriction);
-						bodyA->applyAngularImpulse(sumImpulseA);
-                        bodyA->applyLinearPseudoImpulse(cm.normal, cm.infoPoint[i].pseudoImpulse);
-                        bodyA->applyAngularPseudoImpulse(cm.pointA[i].rn, cm.infoPoint[i].pseudoImpulse);
-                        if (cm.notStatB) {
-                            sumImpulseL = - sumImpulseL;
-							bodyB->applyLinearImpulse(sumImpulseL);
-                            sumImpulseA = (cm.pointB[i].rn * (- cm.infoPoint[i].impulse)) + (cm.pointB[i].rb * (-cm.infoPoint[i].impulseFriction));
-							bodyB->applyAngularImpulse(sumImpulseA);
-                            bodyB->applyLinearPseudoImpulse(cm.normal, (-cm.infoPoint[i].pseudoImpulse));
-                            bodyB->applyAngularPseudoImpulse(cm.pointB[i].rn, (-cm.infoPoint[i].pseudoImpulse));
-						}
-                        ++m_countUsedPrevContacts;
-						flag = false;
-						break;
-					}
-				}
-                if (flag) {
-                    cm.infoPoint[i].impulse = 0.0f;
-                    cm.infoPoint[i].impulseFriction = 0.0f;
-                    cm.infoPoint[i].pseudoImpulse = 0.0f;
-                    m_countNotUsedPrevContacts++;
-				}
-			}
-        } else {
-            for (i = 0; i < cm.countPoints; ++i) {
-				flag = true;
-                for (j = 0; j < prev_cm.countPoints; ++j) {
-                    if ((cm.pointA[i].r - prev_cm.pointA[j].r).inBound(PE_EPS_forContact)) {
-                        cm.infoPoint[i].impulse = prev_cm.infoPoint[j].impulse;
-                        cm.infoPoint[i].impulseFriction = prev_cm.infoPoint[j].impulseFriction;
-                        cm.infoPoint[i].pseudoImpulse = prev_cm.infoPoint[j].pseudoImpulse;
-                        sumImpulseL = (cm.normal * cm.infoPoint[i].impulse) + (cm.infoPoint[i].binormal * cm.infoPoint[i].impulseFriction);
-						bodyA->applyLinearImpulse(sumImpulseL);
-                        sumImpulseA = (cm.pointA[i].rn * cm.infoPoint[i].impulse) + (cm.pointA[i].rb * cm.infoPoint[i].impulseFriction);
-						bodyA->applyAngularImpulse(sumImpulseA);
-                        bodyA->applyLinearPseudoImpulse(cm.normal, cm.infoPoint[i].pseudoImpulse);
-                        bodyA->applyAngularPseudoImpulse(cm.pointA[i].rn, cm.infoPoint[i].pseudoImpulse);
-                        if (cm.notStatB) {
-                            sumImpulseL = - sumImpulseL;
-							bodyB->applyLinearImpulse(sumImpulseL);
-                            sumImpulseA = (cm.pointB[i].rn * (- cm.infoPoint[i].impulse)) + (cm.pointB[i].rb * (- cm.infoPoint[i].impulseFriction));
-							bodyB->applyAngularImpulse(sumImpulseA);
-                            bodyB->applyLinearPseudoImpulse(cm.normal, (-cm.infoPoint[i].pseudoImpulse));
-                            bodyB->applyAngularPseudoImpulse(cm.pointB[i].rn, (-cm.infoPoint[i].pseudoImpulse));
-						}
-                        ++m_countUsedPrevContacts;
-						flag = false;
-						break;
-					}
-				}
-                if (flag) {
-                    cm.infoPoint[i].impulse = 0.0f;
-                    cm.infoPoint[i].impulseFriction = 0.0f;
-                    cm.infoPoint[i].pseudoImpulse = 0.0f;
-                    ++m_countNotUsedPrevContacts;
-				}
-			}
-		}
-    } else {
+    cm.bodyA->addContact(nCM);
+    cm.bodyB->addContact(nCM);
+    ShapePair shapePair(cm.shapeA, cm.shapeB);
+    m_contactManifoldIndices.insert(shapePair, nCM);
+    int prevIndex = m_prev_contactManifoldIndices.find(shapePair);
+    if (prevIndex < 0) {
         for (i = 0; i < cm.countPoints; ++i) {
             cm.infoPoint[i].impulse = 0.0f;
             cm.infoPoint[i].impulseFriction = 0.0f;
             cm.infoPoint[i].pseudoImpulse = 0.0f;
             ++m_countNotUsedPrevContacts;
 		}
+        return;
 	}
+    const ContactManifold& prev_cm = m_prev_contactManifolds[prevIndex];
+    bool inv = (prev_cm.shapeA != cm.shapeA);
+    std::uint32_t feature;
+    for (i = 0; i < cm.countPoints; ++i) {
+        feature = inv ? swappedFeature(cm.infoPoint[i].feature) : cm.infoPoint[i].feature;
+        for (j = 0; j < prev_cm.countPoints; ++j) {
+            if (prev_cm.infoPoint[j].feature == feature)
+                break;
+        }
+        if (j < prev_cm.countPoints) {
+            cm.infoPoint[i].impulse = prev_cm.infoPoint[j].impulse;
+            cm.infoPoint[i].impulseFriction = dot(prev_cm.infoPoint[j].binormal, cm.infoPoint[i].binormal) *
+                    (inv ? - prev_cm.infoPoint[j].impulseFriction : prev_cm.infoPoint[j].impulseFriction);
+            cm.infoPoint[i].pseudoImpulse = prev_cm.infoPoint[j].pseudoImpulse;
+            if (cm.bodyA->nonSleeping())
+                _applyWarmStarting(cm, i);
+            ++m_countUsedPrevContacts;
+        } else {
+            cm.infoPoint[i].impulse = 0.0f;
+            cm.infoPoint[i].impulseFriction = 0.0f;
+            cm.infoPoint[i].pseudoImpulse = 0.0f;
+            ++m_countNotUsedPrevContacts;
+        }
+    }
+}
+
+void ContactsContainer::refreshContacts(float xdt)
+{
+    int j;
+    for (std::size_t i = 0; i < m_countContactManifolds; ++i) {
+        ContactManifold& cm = m_contactManifolds[i];
+        for (j = 0; j < cm.countPoints; ++j) {
+            InfoPointOnCM& info = cm.infoPoint[j];
+            Vector3 pointA = cm.bodyA->position() + cm.bodyA->orientation().vectorRotated(cm.pointA[j].anchor);
+            Vector3 pointB = cm.bodyB->position() + cm.bodyB->orientation().vectorRotated(cm.pointB[j].anchor);
+            float depth = (info.depth - dot(cm.normal, pointA - pointB) - PE_MAIN_DEPTH) * xdt;
+            info.depthA = depth * m_ERP_a;
+            info.depthB = depth * m_ERP_b;
+            if (cm.bodyA->nonSleeping())
+                _applyWarmStarting(cm, j);
+        }
+    }
+}
+
+void ContactsContainer::_setContactAnchors(ContactManifold& cm, int nPoint, const Vector3& pointA, const Vector3& pointB,
+                                           float depth)
+{
+    cm.pointA[nPoint].anchor = cm.bodyA->orientation().vectorToAxis(pointA - cm.bodyA->position());
+    cm.pointB[nPoint].anchor = cm.bodyB->orientation().vectorToAxis(pointB - cm.bodyB->position());
+    cm.infoPoint[nPoint].depth = depth + dot(cm.normal, pointA - pointB);
+}
+
+void ContactsContainer::_swapBodies(ContactManifold& cm)
+{
+    std::swap(cm.bodyA, cm.bodyB);
+    std::swap(cm.shapeA, cm.shapeB);
+    R_ContactPoint t;
+    for (int i = 0; i < cm.countPoints; ++i) {
+        t = cm.pointA[i];
+        cm.pointA[i] = cm.pointB[i];
+        cm.pointB[i] = t;
+        cm.pointA[i].rn = - cm.pointA[i].rn;
+        cm.pointB[i].rn = - cm.pointB[i].rn;
+        cm.pointA[i].rb = - cm.pointA[i].rb;
+        cm.pointB[i].rb = - cm.pointB[i].rb;
+        cm.infoPoint[i].binormal = - cm.infoPoint[i].binormal;
+        cm.infoPoint[i].feature = swappedFeature(cm.infoPoint[i].feature);
+    }
+    cm.normal = - cm.normal;
+}
+
+void ContactsContainer::_applyWarmStarting(ContactManifold& cm, int nPoint)
+{
+    const InfoPointOnCM& info = cm.infoPoint[nPoint];
+    Body* bodyA = cm.bodyA;
+    Vector3 sumImpulseL = (cm.normal * info.impulse) + (info.binormal * info.impulseFriction);
+    bodyA->applyLinearImpulse(sumImpulseL);
+    bodyA->applyAngularImpulse((cm.pointA[nPoint].rn * info.impulse) + (cm.pointA[nPoint].rb * info.impulseFriction));
+    bodyA->applyLinearPseudoImpulse(cm.normal, info.pseudoImpulse);
+    bodyA->applyAngularPseudoImpulse(cm.pointA[nPoint].rn, info.pseudoImpulse);
+    if (cm.notStatB) {
+        Body* bodyB = cm.bodyB;
+        bodyB->applyLinearImpulse(- sumImpulseL);
+        bodyB->applyAngularImpulse((cm.pointB[nPoint].rn * (- info.impulse)) + (cm.pointB[nPoint].rb * (- info.impulseFriction)));
+        bodyB->applyLinearPseudoImpulse(cm.normal, (- info.pseudoImpulse));
+        bodyB->applyAngularPseudoImpulse(cm.pointB[nPoint].rn, (- info.pseudoImpulse));
+    }
 }
 
 void ContactsContainer::deleteAllContacts()
 {
     m_contactManifolds.swap(m_prev_contactManifolds);
-    m_contactManifolds.resize(0);
+    m_countContactManifolds = 0;
+    m_contactManifoldIndices.swap(m_prev_contactManifoldIndices);
+    m_contactManifoldIndices.clear();
     m_countUsedPrevContacts = 0;
     m_countNotUsedPrevContacts = 0;
 }
 
+void ContactsContainer::removeShape(const Shape* shape)
+{
+    m_prev_contactManifoldIndices.remove(shape);
+    m_contactManifoldIndices.remove(shape);
+}
+
 int ContactsContainer::countUsedPrevContacts() const
 {
     return m_countUsedPrevContacts;
@@ -336,15 +354,97 @@ int ContactsContainer::countNotUsedPrevContacts() const
     return m_countNotUsedPrevContacts;
 }
 
-void ContactsContainer::updateCollisionGroups()
+void ContactsContainer::buildIslands()
+{
+    std::size_t i, j;
+    std::uint32_t nodeA, nodeB;
+    m_islandNodes.assign(1, nullptr);
+    m_islandParents.assign(1, 0);
+    for (i = 0; i < m_countContactManifolds; ++i) {
+        const ContactManifold& cm = m_contactManifolds[i];
+        nodeA = _islandNode(cm.bodyA);
+        if (!cm.notStatB)
+            continue;
+        nodeA = _findIslandRoot(nodeA);
+        nodeB = _findIslandRoot(_islandNode(cm.bodyB));
+        if (nodeA != nodeB) {
+            if (nodeA < nodeB)
+                m_islandParents[nodeB] = nodeA;
+            else
+                m_islandParents[nodeA] = nodeB;
+        }
+    }
+    m_islands.resize(0);
+    m_islandIndices.assign(m_islandNodes.size(), 0);
+    for (i = 1; i < m_islandNodes.size(); ++i) {
+        std::uint32_t root = _findIslandRoot((std::uint32_t)i);
+        if (root == i) {
+            m_islandIndices[i] = (std::uint32_t)m_islands.size();
+            m_islands.push_back(Island{ 0, 0, 0, 0, 0, 0 });
+        } else {
+            m_islandIndices[i] = m_islandIndices[root];
+        }
+        ++m_islands[m_islandIndices[i]].countBodies;
+    }
+    for (i = 0; i < m_countContactManifolds; ++i)
+        ++m_islands[m_islandIndices[m_contactManifolds[i].bodyA->m_islandNode]].countManifolds;
+    std::size_t firstBody = 0, firstManifold = 0;
+    for (i = 0; i < m_islands.size(); ++i) {
+        m_islands[i].firstBody = firstBody;
+        m_islands[i].firstManifold = firstManifold;
+        firstBody += m_islands[i].countBodies;
+        firstManifold += m_islands[i].countManifolds;
+        m_islands[i].countBodies = m_islands[i].countManifolds = 0;
+    }
+    m_islandBodies.resize(firstBody);
+    m_islandManifolds.resize(firstManifold);
+    for (i = 1; i < m_islandNodes.size(); ++i) {
+        Island& island = m_islands[m_islandIndices[i]];
+        m_islandBodies[island.firstBody + island.countBodies] = m_islandNodes[i];
+        ++island.countBodies;
+    }
+    for (i = 0; i < m_countContactManifolds; ++i) {
+        Island& island = m_islands[m_islandIndices[m_contactManifolds[i].bodyA->m_islandNode]];
+        m_islandManifolds[island.firstManifold + island.countManifolds] = i;
+        ++island.countManifolds;
+    }
+    for (i = 0; i < m_islands.size(); ++i) {
+        const Island& island = m_islands[i];
+        Body* first = m_islandBodies[island.firstBody];
+        for (j = 1; j < island.countBodies; ++j) {
+            Body* body = m_islandBodies[island.firstBody + j];
+            if (body->m_index < first->m_index)
+                first = body;
+        }
+        for (j = 0; j < island.countBodies; ++j)
+            m_islandBodies[island.firstBody + j]->m_currentCollisionGroup = first->m_defaultCollisionGroup;
+    }
+    for (i = 1; i < m_islandNodes.size(); ++i)
+        m_islandNodes[i]->m_islandNode = 0;
+}
+
+std::uint32_t ContactsContainer::_islandNode(Body* body)
 {
-    for (auto it = m_contactManifolds.begin(); it != m_contactManifolds.end(); ++it)
-        it->bodyA->_mergeCollisionGroup(it->bodyB);
+    if (body->m_islandNode == 0) {
+        body->m_islandNode = (std::uint32_t)m_islandNodes.size();
+        m_islandNodes.push_back(body);
+        m_islandParents.push_back(body->m_islandNode);
+    }
+    return body->m_islandNode;
+}
+
+std::uint32_t ContactsContainer::_findIslandRoot(std::uint32_t node)
+{
+    while (m_islandParents[node] != node) {
+        m_islandParents[node] = m_islandParents[m_islandParents[node]];
+        node = m_islandParents[node];
+    }
+    return node;
 }
 
 std::size_t ContactsContainer::countContactManifolds() const
 {
-    return m_contactManifolds.size();
+    return m_countContactManifolds;
 }
 
 const ContactsContainer::ContactManifold& ContactsContainer::contactManifold(std::size_t index) const
@@ -352,4 +452,25 @@ const ContactsContainer::ContactManifold& ContactsContainer::contactManifold(std
     return m_contactManifolds[index];
 }
 
+std::size_t ContactsContainer::countIslands() const
+{
+    return m_islands.size();
+}
+
+const ContactsContainer::Island& ContactsContainer::island(std::size_t index) const
+{
+    return m_islands[index];
+}
+
+Body* ContactsContainer::islandBody(const Island& island, std::size_t index) const
+{
+    return m_islandBodies[island.firstBody + index];
+}
+
+const ContactsContainer::ContactManifold& ContactsContainer::islandContactManifold(const Island& island,
+                                                                                 std::size_t index) const
+{
+    return m_contactManifolds[m_islandManifolds[island.firstManifold + index]];
+}
+
 } // namespace PE
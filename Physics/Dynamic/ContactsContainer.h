@@ -7,6 +7,7 @@
 #include "../Bodies/Body.h"
 #include "../Bodies/Material.h"
 #include "ContactTypes.h"
+#include "ShapePairMap.h"
 
 namespace PE {
 
@@ -18,37 +19,65 @@ public:
 
     void setERP(float a, float b);
     void clearCMPoints();
-    int addContactManifold(Body* bodyA, Body* bodyB, const Vector3& normal, const Material& material);
+    int addContactManifold(Shape* shapeA, Shape* shapeB, const Vector3& normal, const Material& material);
     void computeBinormalOnCM_notStatB(int nCM, int nPoint);
     void solveBinormalOnCM_statB(int nCM, int nPoint);
     void addContact(int nCM, ContactPoint& contactPoint, float xdt);
+    void addFeatureContact(int nCM, const ContactPoint& contactPoint, float xdt);
     void addContact_static(int nCM, const Vector3& contactPoint, float depth, float xdt);
-    void addTempContactPoint(const Vector3& pointOnBodyA, const Vector3& pointOnBodyB, float depth);
-    void addTempContactPoint_static(const Vector3& pointOnBodyA, float depth);
+    void addTempContactPoint(const Vector3& pointOnBodyA, const Vector3& pointOnBodyB, float depth, std::uint32_t feature);
+    void addTempContactPoint_static(const Vector3& pointOnBodyA, float depth, std::uint32_t feature);
     bool optimizeContactPoints(int nCM, const Vector3& normal, float xdt);
     void compareContacts(int nCM);
+    // Recomputes depths from the contact anchors after bodies moved and warm starts again, normals and
+    // lever arms are kept from the narrowphase.
+    void refreshContacts(float xdt);
     void deleteAllContacts();
+    // Forgets the manifolds of a shape leaving its body, so a new shape at the same address does not
+    // take their impulses.
+    void removeShape(const Shape* shape);
 
     int countUsedPrevContacts() const;
     int countNotUsedPrevContacts() const;
 
-    void updateCollisionGroups();
+    void buildIslands();
 
     std::size_t countContactManifolds() const;
     const ContactManifold& contactManifold(std::size_t index) const;
 
+    std::size_t countIslands() const;
+    const Island& island(std::size_t index) const;
+    Body* islandBody(const Island& island, std::size_t index) const;
+    const ContactManifold& islandContactManifold(const Island& island, std::size_t index) const;
+
 protected:
     ContactPoint m_tempCMPoints[PE_MaxCountTempCMPoint];
     int m_countCMPoints;
     ContactPoint* m_contacts[4];
     std::vector<ContactManifold> m_prev_contactManifolds;
     std::vector<ContactManifold> m_contactManifolds;
+    std::size_t m_countContactManifolds;
+    ShapePairMap m_prev_contactManifoldIndices;
+    ShapePairMap m_contactManifoldIndices;
 
     float m_ERP_a;
     float m_ERP_b;
 
     int m_countUsedPrevContacts;
     int m_countNotUsedPrevContacts;
+
+    std::vector<Island> m_islands;
+    std::vector<Body*> m_islandBodies;
+    std::vector<std::size_t> m_islandManifolds;
+    std::vector<Body*> m_islandNodes;
+    std::vector<std::uint32_t> m_islandParents;
+    std::vector<std::uint32_t> m_islandIndices;
+
+    void _swapBodies(ContactManifold& cm);
+    void _applyWarmStarting(ContactManifold& cm, int nPoint);
+    void _setContactAnchors(ContactManifold& cm, int nPoint, const Vector3& pointA, const Vector3& pointB, float depth);
+    std::uint32_t _islandNode(Body* body);
+    std::uint32_t _findIslandRoot(std::uint32_t node);
 };
 
 } // namespace PE
@@ -0,0 +1,172 @@
+#include "JacobiSolver.h"
+#include <cmath>
+#include <algorithm>
+
+namespace PE {
+
+JacobiSolver::JacobiSolver():
+    Solver()
+{
+    // All rows of an iteration read the same velocities, so the order coloring keeps is not needed.
+    m_enableColoring = false;
+}
+
+void JacobiSolver::solveIsland(SolverContext& context, Island& island)
+{
+    preSolve(context, island);
+    _computeRowScales(context);
+    float tolerance = residualTolerance() * PE_JacobiResidualToleranceScale;
+    island.countIterations = 0;
+    while (island.countIterations < solverCountIterations()) {
+        ++island.countIterations;
+        _forEachRows(context, island, &JacobiSolver::_computeImpulses);
+        if (_applyImpulses(context) < tolerance)
+            break;
+    }
+    island.countSplitImpulsesIterations = 0;
+    while (island.countSplitImpulsesIterations < splitImpulsesIterations()) {
+        ++island.countSplitImpulsesIterations;
+        _forEachRows(context, island, &JacobiSolver::_computePseudoImpulses);
+        if (_applyPseudoImpulses(context) < tolerance)
+            break;
+    }
+    storeImpulses(context);
+    storeSolverBodies(context);
+}
+
+void JacobiSolver::_computeRowScales(SolverContext& context)
+{
+    const ContactConstraints& constraints = context.constraints;
+    std::size_t i, count = constraints.count();
+    context.bodyCountRows.assign(context.solverBodies.size(), 0.0f);
+    for (i = 0; i < count; ++i) {
+        if (constraints.manifold[i] < 0)
+            continue;
+        context.bodyCountRows[constraints.bodyA[i]] += 1.0f;
+        context.bodyCountRows[constraints.bodyB[i]] += 1.0f;
+    }
+    context.bodyCountRows[0] = 1.0f;
+    context.rowScale.resize(count);
+    context.rowImpulse.resize(count);
+    context.rowImpulseFriction.resize(count);
+    for (i = 0; i < count; ++i) {
+        if (constraints.manifold[i] < 0) {
+            context.rowScale[i] = 0.0f;
+            continue;
+        }
+        context.rowScale[i] = 1.0f / std::max(context.bodyCountRows[constraints.bodyA[i]],
+                                              context.bodyCountRows[constraints.bodyB[i]]);
+    }
+}
+
+void JacobiSolver::_forEachRows(SolverContext& context, const Island& island, RowsFunction function)
+{
+    std::size_t count = context.constraints.count();
+    int countThreads = m_threadPool.countThreads();
+    if ((countThreads == 1) || (island.countManifolds < PE_SolverColoringMinManifolds)) {
+        (this->*function)(context, 0, count);
+        return;
+    }
+    std::size_t countRowsPerThread = (count + countThreads - 1) / countThreads;
+    m_threadPool.run([this, &context, function, count, countRowsPerThread] (int threadIndex) {
+        std::size_t first = threadIndex * countRowsPerThread;
+        std::size_t end = std::min(first + countRowsPerThread, count);
+        if (first < end)
+            (this->*function)(context, first, end);
+    });
+}
+
+void JacobiSolver::_computeImpulses(SolverContext& context, std::size_t first, std::size_t end)
+{
+    const ContactConstraints& constraints = context.constraints;
+    const std::vector<SolverBody>& solverBodies = context.solverBodies;
+    for (std::size_t i = first; i < end; ++i) {
+        if (constraints.manifold[i] < 0) {
+            context.rowImpulse[i] = context.rowImpulseFriction[i] = 0.0f;
+            continue;
+        }
+        const SolverBody& bodyA = solverBodies[constraints.bodyA[i]];
+        const SolverBody& bodyB = solverBodies[constraints.bodyB[i]];
+        float nVelProj = dot(bodyA.velocity - bodyB.velocity, constraints.normal[i]) +
+                         dot(bodyA.angularVelocity, constraints.rnA[i]) -
+                         dot(bodyB.angularVelocity, constraints.rnB[i]);
+        float impulse = (constraints.depthA[i] - constraints.e[i] * nVelProj) / constraints.kNormal[i];
+        impulse = std::max(constraints.impulse[i] + impulse, 0.0f) - constraints.impulse[i];
+        context.rowImpulse[i] = impulse;
+        float bVelProj = dot(bodyA.velocity - bodyB.velocity, constraints.binormal[i]) +
+                         dot(bodyA.angularVelocity, constraints.rbA[i]) -
+                         dot(bodyB.angularVelocity, constraints.rbB[i]);
+        float impulseMax = (constraints.impulse[i] + impulse * context.rowScale[i]) * constraints.mu[i];
+        float old = constraints.impulseFriction[i];
+        context.rowImpulseFriction[i] = std::max(- impulseMax, std::min(old - bVelProj / constraints.kBinormal[i],
+                                                                        impulseMax)) - old;
+    }
+}
+
+void JacobiSolver::_computePseudoImpulses(SolverContext& context, std::size_t first, std::size_t end)
+{
+    const ContactConstraints& constraints = context.constraints;
+    const std::vector<SolverBody>& solverBodies = context.solverBodies;
+    for (std::size_t i = first; i < end; ++i) {
+        if (constraints.manifold[i] < 0) {
+            context.rowImpulse[i] = 0.0f;
+            continue;
+        }
+        const SolverBody& bodyA = solverBodies[constraints.bodyA[i]];
+        const SolverBody& bodyB = solverBodies[constraints.bodyB[i]];
+        float nVelProj = dot(bodyA.pseudoVelocity - bodyB.pseudoVelocity, constraints.normal[i]) +
+                         dot(bodyA.pseudoAngularVelocity, constraints.rnA[i]) -
+                         dot(bodyB.pseudoAngularVelocity, constraints.rnB[i]);
+        float pseudoImpulse = (constraints.depthB[i] - nVelProj) / constraints.kPseudo[i];
+        context.rowImpulse[i] = std::max(constraints.pseudoImpulse[i] + pseudoImpulse, 0.0f) -
+                constraints.pseudoImpulse[i];
+    }
+}
+
+float JacobiSolver::_applyImpulses(SolverContext& context)
+{
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    std::size_t count = constraints.count();
+    float residual = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (constraints.manifold[i] < 0)
+            continue;
+        float impulse = context.rowImpulse[i] * context.rowScale[i];
+        float impulseFriction = context.rowImpulseFriction[i] * context.rowScale[i];
+        constraints.impulse[i] += impulse;
+        constraints.impulseFriction[i] += impulseFriction;
+        residual = std::max(residual, std::max(std::fabs(impulse), std::fabs(impulseFriction)));
+        SolverBody& bodyA = solverBodies[constraints.bodyA[i]];
+        bodyA.applyImpulse(constraints.normal[i], constraints.invInertiaRnA[i], impulse);
+        bodyA.applyImpulse(constraints.binormal[i], constraints.invInertiaRbA[i], impulseFriction);
+        if (constraints.bodyB[i] != 0) {
+            SolverBody& bodyB = solverBodies[constraints.bodyB[i]];
+            bodyB.applyImpulse(constraints.normal[i], constraints.invInertiaRnB[i], - impulse);
+            bodyB.applyImpulse(constraints.binormal[i], constraints.invInertiaRbB[i], - impulseFriction);
+        }
+    }
+    return residual;
+}
+
+float JacobiSolver::_applyPseudoImpulses(SolverContext& context)
+{
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    std::size_t count = constraints.count();
+    float residual = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (constraints.manifold[i] < 0)
+            continue;
+        float pseudoImpulse = context.rowImpulse[i] * context.rowScale[i];
+        constraints.pseudoImpulse[i] += pseudoImpulse;
+        residual = std::max(residual, std::fabs(pseudoImpulse));
+        solverBodies[constraints.bodyA[i]].applyPseudoImpulse(constraints.normal[i], constraints.invInertiaRnA[i], pseudoImpulse);
+        if (constraints.bodyB[i] != 0)
+            solverBodies[constraints.bodyB[i]].applyPseudoImpulse(constraints.normal[i], constraints.invInertiaRnB[i],
+                                                                  - pseudoImpulse);
+    }
+    return residual;
+}
+
+} // namespace PE
@@ -0,0 +1,35 @@
+#ifndef PE_JACOBISOLVER_H
+#define PE_JACOBISOLVER_H
+
+#include "ContactTypes.h"
+#include "ContactConstraints.h"
+#include "Solver.h"
+
+namespace PE {
+
+// Every iteration computes all contact impulses from the same velocities and applies them at once,
+// each scaled down by the contact count of its busiest body. Rows are independent, so an island is
+// split across threads without coloring, but it needs more iterations than Gauss-Seidel to come to
+// rest and tall stacks sag more at the same iteration count.
+class JacobiSolver:
+        public Solver
+{
+public:
+    JacobiSolver();
+
+    void solveIsland(SolverContext& context, Island& island) override;
+
+private:
+    typedef void (JacobiSolver::*RowsFunction)(SolverContext& context, std::size_t first, std::size_t end);
+
+    void _computeRowScales(SolverContext& context);
+    void _forEachRows(SolverContext& context, const Island& island, RowsFunction function);
+    void _computeImpulses(SolverContext& context, std::size_t first, std::size_t end);
+    void _computePseudoImpulses(SolverContext& context, std::size_t first, std::size_t end);
+    float _applyImpulses(SolverContext& context);
+    float _applyPseudoImpulses(SolverContext& context);
+};
+
+} // namespace PE
+
+#endif // PE_JACOBISOLVER_H
@@ -0,0 +1,101 @@
+#include "ShapePairMap.h"
+#include <utility>
+
+namespace PE {
+
+ShapePairMap::ShapePairMap()
+{
+    m_count = 0;
+    m_shift = 64;
+}
+
+std::size_t ShapePairMap::count() const
+{
+    return m_count;
+}
+
+void ShapePairMap::clear()
+{
+    if (m_count == 0)
+        return;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        it->shapeA = nullptr;
+    m_count = 0;
+}
+
+void ShapePairMap::insert(const ShapePair& pair, int value)
+{
+    if ((m_count + 1) * 2 > m_entries.size())
+        _grow();
+    std::size_t mask = m_entries.size() - 1;
+    for (std::size_t index = _indexEntry(pair); ; index = (index + 1) & mask) {
+        Entry& entry = m_entries[index];
+        if (entry.shapeA == nullptr) {
+            entry.shapeA = pair.shapeA;
+            entry.shapeB = pair.shapeB;
+            entry.value = value;
+            ++m_count;
+            return;
+        }
+        if ((entry.shapeA == pair.shapeA) && (entry.shapeB == pair.shapeB)) {
+            entry.value = value;
+            return;
+        }
+    }
+}
+
+int ShapePairMap::find(const ShapePair& pair) const
+{
+    if (m_count == 0)
+        return -1;
+    std::size_t mask = m_entries.size() - 1;
+    for (std::size_t index = _indexEntry(pair); ; index = (index + 1) & mask) {
+        const Entry& entry = m_entries[index];
+        if (entry.shapeA == nullptr)
+            return -1;
+        if ((entry.shapeA == pair.shapeA) && (entry.shapeB == pair.shapeB))
+            return entry.value;
+    }
+}
+
+void ShapePairMap::remove(const Shape* shape)
+{
+    if (m_count == 0)
+        return;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if ((it->shapeA != nullptr) && ((it->shapeA == shape) || (it->shapeB == shape)))
+            it->value = -1;
+    }
+}
+
+void ShapePairMap::swap(ShapePairMap& map)
+{
+    m_entries.swap(map.m_entries);
+    std::swap(m_count, map.m_count);
+    std::swap(m_shift, map.m_shift);
+}
+
+std::size_t ShapePairMap::_indexEntry(const ShapePair& pair) const
+{
+    // Shapes come from pools and are aligned, the multiplication spreads the hash into the high bits.
+    std::uint64_t hash = ShapePairHash()(pair);
+    return (std::size_t)((hash * 0x9E3779B97F4A7C15ull) >> m_shift);
+}
+
+void ShapePairMap::_grow()
+{
+    std::vector<Entry> entries(m_entries.empty() ? 64 : m_entries.size() * 2);
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+        it->shapeA = nullptr;
+    entries.swap(m_entries);
+    m_shift = 64;
+    for (std::size_t size = m_entries.size(); size > 1; size >>= 1)
+        --m_shift;
+    m_count = 0;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->shapeA != nullptr)
+            insert(ShapePair(it->shapeA, it->shapeB), it->value);
+    }
+}
+
+} // namespace PE
@@ -0,0 +1,46 @@
+#ifndef PE_SHAPEPAIRMAP_H
+#define PE_SHAPEPAIRMAP_H
+
+#include <vector>
+#include <cstdint>
+#include "../Bodies/Shape.h"
+
+namespace PE {
+
+// Open addressing map from shape pairs to indices. Clearing keeps the table, so a step with no more pairs
+// than the busiest step before it does not allocate.
+class ShapePairMap
+{
+public:
+    ShapePairMap();
+
+    std::size_t count() const;
+
+    void clear();
+    void insert(const ShapePair& pair, int value);
+    // Returns -1 if the pair is not in the map.
+    int find(const ShapePair& pair) const;
+    // Removes all pairs of the shape. Their slots stay taken until the map is cleared, so probing is not broken.
+    void remove(const Shape* shape);
+
+    void swap(ShapePairMap& map);
+
+private:
+    struct Entry
+    {
+        const Shape* shapeA;
+        const Shape* shapeB;
+        int value;
+    };
+
+    std::vector<Entry> m_entries;
+    std::size_t m_count;
+    int m_shift;
+
+    std::size_t _indexEntry(const ShapePair& pair) const;
+    void _grow();
+};
+
+} // namespace PE
+
+#endif // PE_SHAPEPAIRMAP_H
@@ -49,99 +49,67 @@ void ShockPropagationSolver::solvePseudoImpulseSP(Body* bodyA, const Vector3& no
 	}
 }
 
-void ShockPropagationSolver::_swapBodyOnContactManifold(ContactManifold& cM)
+inline void ShockPropagationSolver::_computeGraph(SolverContext& context, const Island& island)
 {
-    std::swap(cM.bodyA, cM.bodyB);
-    R_ContactPoint t;
-    for (int i = 0; i < cM.countPoints; ++i) {
-		t = cM.pointA[i];
-		cM.pointA[i] = cM.pointB[i];
-		cM.pointB[i] = t;
-		cM.pointA[i].rn = - cM.pointA[i].rn;
-		cM.pointB[i].rn = - cM.pointB[i].rn;
-		cM.pointA[i].rb = - cM.pointA[i].rb;
-		cM.pointB[i].rb = - cM.pointB[i].rb;
-	}
-    cM.normal = - cM.normal;
-}
-
-inline void ShockPropagationSolver::_computeGraph()
-{
-    m_graph_contactManifolds.resize(0);
-    std::size_t i, j, k, levelA, levelB;
-    for (i = 0; i < m_contactManifolds.size(); ++i) {
-        if (!m_contactManifolds[i].notStatB) {
-            m_contactManifolds[i].solved = true;
-            m_graph_contactManifolds.push_back(i);
-		}
-	}
-    m_countStaticContacts = m_graph_contactManifolds.size();
-
-	bool flag_local;
-	levelB = 0;
-    levelA = m_graph_contactManifolds.size();
-    while (levelB != m_graph_contactManifolds.size()) {
-        for (i = 0; i < m_contactManifolds.size(); ++i) {
-            ContactManifold& cm = m_contactManifolds[i];
-            if (cm.solved == false) {
-                cm.bodyA->_mergeCollisionGroup(cm.bodyB);
-                for (j = levelB; j < levelA; ++j) {
-                    if (m_contactManifolds[m_graph_contactManifolds[j]].bodyA == cm.bodyA) {
-                        cm.solved = true;
-						flag_local = true;
-                        for (k = levelB; k < levelA; ++k) {
-                            if (m_contactManifolds[m_graph_contactManifolds[k]].bodyA == cm.bodyB) {
-                                cm.solved = true;
-								flag_local = false;
-								break;
-							}
-						}
-                        if (flag_local) {
-                            cm.bodyB->m_level = levelA;
-                            _swapBodyOnContactManifold(cm);
-                            m_graph_contactManifolds.push_back(i);
-							break;
-						}
-                    } else if (m_contactManifolds[m_graph_contactManifolds[j]].bodyA == cm.bodyB) {
-                        cm.solved = true;
-						flag_local = true;
-                        for (k = levelB; k < levelA; ++k) {
-                            if (m_contactManifolds[m_graph_contactManifolds[k]].bodyA == cm.bodyA) {
-                                cm.solved = true;
-								flag_local = false;
-								break;
-							}
-						}
-                        if (flag_local) {
-                            cm.bodyA->m_level = levelA;
-                            //_swapBodyOnContactManifold(cm);
-                            m_graph_contactManifolds.push_back(i);
-							break;
-						}
-					}
-				}
-			}
-		}
-		levelB = levelA;
-        levelA = m_graph_contactManifolds.size();
-	}
+    std::vector<std::size_t>& graphContactManifolds = context.graphContactManifolds;
+    std::vector<Body*>& graphBodies = context.graphBodies;
+    graphContactManifolds.resize(0);
+    graphBodies.resize(0);
+    std::size_t i, j, index;
+    for (i = 0; i < island.countBodies; ++i)
+        m_islandBodies[island.firstBody + i]->m_level = -1;
+    for (i = 0; i < island.countManifolds; ++i) {
+        index = m_islandManifolds[island.firstManifold + i];
+        ContactManifold& cm = m_contactManifolds[index];
+        if (cm.notStatB)
+            continue;
+        cm.solved = true;
+        graphContactManifolds.push_back(index);
+        if (cm.bodyA->m_level < 0) {
+            cm.bodyA->m_level = 0;
+            graphBodies.push_back(cm.bodyA);
+        }
+    }
+    context.countStaticContacts = graphContactManifolds.size();
+    // Breadth-first from the bodies lying on static ones. A manifold leading to the next level is turned
+    // so that its bodyB is on the lower level, manifolds within one level are left out.
+    for (i = 0; i < graphBodies.size(); ++i) {
+        Body* body = graphBodies[i];
+        for (j = 0; j < body->m_contacts.size(); ++j) {
+            index = body->m_contacts[j];
+            ContactManifold& cm = m_contactManifolds[index];
+            if (cm.solved)
+                continue;
+            cm.solved = true;
+            Body* other = (cm.bodyA == body) ? cm.bodyB : cm.bodyA;
+            if (other->m_level == body->m_level)
+                continue;
+            if (other->m_level < 0) {
+                other->m_level = body->m_level + 1;
+                graphBodies.push_back(other);
+            }
+            if (cm.bodyA == body)
+                _swapBodies(cm);
+            graphContactManifolds.push_back(index);
+        }
+    }
 }
 
-void ShockPropagationSolver::solveShockPropagation()
+void ShockPropagationSolver::solveShockPropagation(SolverContext& context, const Island& island)
 {
-    _computeGraph();
+    _computeGraph(context, island);
     std::size_t i;
     int j;
-    for (i = 0; i < m_countStaticContacts; ++i) {
-        ContactManifold& cm = m_contactManifolds[m_graph_contactManifolds[i]];
+    for (i = 0; i < context.countStaticContacts; ++i) {
+        ContactManifold& cm = m_contactManifolds[context.graphContactManifolds[i]];
         for (j = 0; j < cm.countPoints; ++j) {
             solveImpulse_static(cm.e, cm.bodyA, cm.normal, cm.pointA[j], cm.infoPoint[j]);
             solveImpulseFriction_static(cm.mu, cm.bodyA, cm.pointA[j], cm.infoPoint[j]);
             solvePseudoImpulse_static(cm.bodyA, cm.normal, cm.pointA[j], cm.infoPoint[j]);
 		}
 	}
-    for (i = m_countStaticContacts; i < m_graph_contactManifolds.size(); ++i) {
-        ContactManifold& cm = m_contactManifolds[m_graph_contactManifolds[i]];
+    for (i = context.countStaticContacts; i < context.graphContactManifolds.size(); ++i) {
+        ContactManifold& cm = m_contactManifolds[context.graphContactManifolds[i]];
         for (j = 0; j < cm.countPoints; ++j) {
             preSolve_static(cm, cm.bodyA);
             solveImpulseSP(cm.e, cm.bodyA, cm.normal, cm.pointA[j], cm.infoPoint[j]);
@@ -151,11 +119,11 @@ void ShockPropagationSolver::solveShockPropagation()
 	}
 }
 
-void ShockPropagationSolver::solve()
+void ShockPropagationSolver::solveIsland(SolverContext& context, Island& island)
 {
-    Solver::solve();
+    Solver::solveIsland(context, island);
     if (m_enableShockPropagation)
-        solveShockPropagation();
+        solveShockPropagation(context, island);
 }
 
 } // namespace PE
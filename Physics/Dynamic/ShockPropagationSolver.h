@@ -22,17 +22,14 @@ public:
     void solveImpulseSP(float e, Body* bodyA, const Vector3& normal, const R_ContactPoint& cPA, const InfoPointOnCM& cInfo);
     void solveImpulseFrictionSP(float mu, Body* bodyA, const R_ContactPoint& cPA, const InfoPointOnCM& cInfo);
     void solvePseudoImpulseSP(Body* bodyA, const Vector3& normal, const R_ContactPoint& cPA, const InfoPointOnCM& cInfo);
-    void solveShockPropagation();
+    void solveShockPropagation(SolverContext& context, const Island& island);
 
-    void solve() override;
+    void solveIsland(SolverContext& context, Island& island) override;
 
 private:
-    std::vector<std::size_t> m_graph_contactManifolds;
-    std::size_t m_countStaticContacts;
     bool m_enableShockPropagation;
 
-    void _swapBodyOnContactManifold(ContactManifold& cM);
-    void _computeGraph();
+    void _computeGraph(SolverContext& context, const Island& island);
 };
 
 } // namespace PE
@@ -1,13 +1,156 @@
 #include "Solver.h"
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+
+#if (PE_SolverSIMD) && (PE_SolverSIMDWidth == 4) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define PE_SOLVER_SSE2
+#include "../VectorMath/Vector3x4.h"
+#endif
+
+#if (PE_SolverSIMD)
+#define PE_SOLVER_LANES PE_SolverSIMDWidth
+#else
+#define PE_SOLVER_LANES 1
+#endif
 
 namespace PE {
 
+#if defined(PE_SOLVER_SSE2)
+inline Vector3x4 gatherSolverBodies(const std::vector<SolverBody>& bodies, const std::uint32_t* indices,
+                                    Vector3 SolverBody::* member)
+{
+    Vector3 v[4] = { bodies[indices[0]].*member, bodies[indices[1]].*member,
+                     bodies[indices[2]].*member, bodies[indices[3]].*member };
+    return Vector3x4::load(v);
+}
+
+inline __m128 gatherSolverBodies(const std::vector<SolverBody>& bodies, const std::uint32_t* indices,
+                                 float SolverBody::* member)
+{
+    return _mm_setr_ps(bodies[indices[0]].*member, bodies[indices[1]].*member,
+                       bodies[indices[2]].*member, bodies[indices[3]].*member);
+}
+
+inline float horizontalMaxAbs(__m128 v)
+{
+    v = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(v);
+}
+
+inline void scatterSolverBodies(std::vector<SolverBody>& bodies, const std::uint32_t* indices,
+                                Vector3 SolverBody::* linear, Vector3 SolverBody::* angular, float SolverBody::* invMass,
+                                const Vector3x4& direction, const Vector3x4& invInertiaR, __m128 impulse)
+{
+    Vector3x4 linearDelta = direction * _mm_mul_ps(gatherSolverBodies(bodies, indices, invMass), impulse);
+    Vector3x4 angularDelta = invInertiaR * impulse;
+    Vector3 l[4], a[4];
+    linearDelta.store(l);
+    angularDelta.store(a);
+    for (int k = 0; k < 4; ++k) {
+        if (indices[k] == 0)
+            continue;
+        SolverBody& body = bodies[indices[k]];
+        body.*linear += l[k];
+        body.*angular += a[k];
+    }
+}
+#endif
+
+// Solves the contacts in mask as active and checks that the rest would separate on their own.
+inline bool solveContactSubset(const float a[][PE_MaxCountContactManifoldPoints], const float* q, int n, int mask,
+                               float* x)
+{
+    float m[PE_MaxCountContactManifoldPoints][PE_MaxCountContactManifoldPoints + 1];
+    int rows[PE_MaxCountContactManifoldPoints];
+    int i, j, k, count = 0;
+    for (i = 0; i < n; ++i) {
+        x[i] = 0.0f;
+        if ((mask >> i) & 1)
+            rows[count++] = i;
+    }
+    for (i = 0; i < count; ++i) {
+        for (j = 0; j < count; ++j)
+            m[i][j] = a[rows[i]][rows[j]];
+        m[i][count] = - q[rows[i]];
+    }
+    for (k = 0; k < count; ++k) {
+        if (m[k][k] < a[rows[k]][rows[k]] * 1e-4f)
+            return false;
+        for (i = k + 1; i < count; ++i) {
+            float f = m[i][k] / m[k][k];
+            for (j = k; j <= count; ++j)
+                m[i][j] -= f * m[k][j];
+        }
+    }
+    for (k = count - 1; k >= 0; --k) {
+        float v = m[k][count];
+        for (j = k + 1; j < count; ++j)
+            v -= m[k][j] * x[rows[j]];
+        x[rows[k]] = v / m[k][k];
+        if (x[rows[k]] < 0.0f)
+            return false;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((mask >> i) & 1)
+            continue;
+        float w = q[i];
+        for (j = 0; j < n; ++j)
+            w += a[i][j] * x[j];
+        if (w < - PE_EPSf)
+            return false;
+    }
+    return true;
+}
+
 Solver::Solver():
     CollisionDetected()
 {
     m_solverCountIterations = 8;
     m_splitImpulsesIterations = 3;
+    m_residualTolerance = PE_SolverResidualTolerance;
+    m_enableBlockSolver = false;
+    m_enableColoring = true;
+    m_contexts.resize(1);
+    m_countLargeIslands = 0;
+}
+
+Solver::~Solver()
+{
+}
+
+float Solver::residualTolerance() const
+{
+    return m_residualTolerance;
+}
+
+void Solver::setResidualTolerance(float residualTolerance)
+{
+    m_residualTolerance = residualTolerance;
+}
+
+bool Solver::enableBlockSolver() const
+{
+    return m_enableBlockSolver;
+}
+
+void Solver::setEnableBlockSolver(bool enable)
+{
+    m_enableBlockSolver = enable;
+}
+
+int Solver::countThreads() const
+{
+    return m_threadPool.countThreads();
+}
+
+void Solver::setCountThreads(int countThreads)
+{
+    m_threadPool.setCountThreads(std::max(countThreads, 1));
+    m_contexts.resize(m_threadPool.countThreads());
 }
 
 void Solver::setCountIterations(int solverCountIterations, int splitImpulsesCountIterations)
@@ -29,77 +172,31 @@ int Solver::splitImpulsesIterations() const
 void Solver::preSolve(ContactManifold& cM, Body* bodyA, Body* bodyB)
 {
 	cM.solved = false;
-	int i;
     float invMassSum = bodyA->m_invMass + bodyB->m_invMass;
-#if (PE_BodyInertia == 3)
-    Vector3 invInertiaA = bodyA->m_invInertia, invInertiaB = bodyB->m_invInertia;
-    for (i = 0; i < cM.countPoints; ++i) {
-        cM.infoPoint[i].kNormal = invMassSum +
-                (dot(cM.pointA[i].rn, Vector3(cM.pointA[i].rn.x * invInertiaA.x,
-                                              cM.pointA[i].rn.y * invInertiaA.y,
-                                              cM.pointA[i].rn.z * invInertiaA.z))) +
-                (dot(cM.pointB[i].rn, Vector3(cM.pointB[i].rn.x * invInertiaB.x,
-                                              cM.pointB[i].rn.y * invInertiaB.y,
-                                              cM.pointB[i].rn.z * invInertiaB.z)));
-        cM.infoPoint[i].kBinormal = invMassSum +
-                (dot(cM.pointA[i].rb, Vector3(cM.pointA[i].rb.x * invInertiaA.x,
-                                              cM.pointA[i].rb.y * invInertiaA.y,
-                                              cM.pointA[i].rb.z * invInertiaA.z))) +
-                (dot(cM.pointB[i].rb, Vector3(cM.pointB[i].rb.x * invInertiaB.x,
-                                              cM.pointB[i].rb.y * invInertiaB.y,
-                                              cM.pointB[i].rb.z * invInertiaB.z)));
-        cM.infoPoint[i].kPseudo = 2.0f +
-                (dot(cM.pointA[i].rb, Vector3(cM.pointA[i].rb.x * invInertiaA.x,
-                                              cM.pointA[i].rb.y * invInertiaA.y,
-                                              cM.pointA[i].rb.z * invInertiaA.z))) +
-                (dot(cM.pointB[i].rb, Vector3(cM.pointB[i].rb.x * invInertiaB.x,
-                                              cM.pointB[i].rb.y * invInertiaB.y,
-                                              cM.pointB[i].rb.z * invInertiaB.z)));
-	}
-#else
-    float invInertiaA = bodyA->m_invInertia, invInertiaB = bodyB->m_invInertia;
-    for (i = 0; i < cM.countPoints; ++i) {
-        cM.infoPoint[i].kNormal = invMassSum +
-                (invInertiaA * dot(cM.pointA[i].rn, cM.pointA[i].rn)) +
-                (invInertiaB * dot(cM.pointB[i].rn, cM.pointB[i].rn));
+    for (int i = 0; i < cM.countPoints; ++i) {
+        const R_ContactPoint& pointA = cM.pointA[i];
+        const R_ContactPoint& pointB = cM.pointB[i];
+        float angularNormal = dot(pointA.rn, bodyA->invInertiaMul(pointA.rn)) +
+                dot(pointB.rn, bodyB->invInertiaMul(pointB.rn));
+        cM.infoPoint[i].kNormal = invMassSum + angularNormal;
         cM.infoPoint[i].kBinormal = invMassSum +
-                (invInertiaA * dot(cM.pointA[i].rb, cM.pointA[i].rb)) +
-                (invInertiaB * dot(cM.pointB[i].rb, cM.pointB[i].rb));
-        cM.infoPoint[i].kPseudo = 2.0f +
-                (invInertiaA * dot(cM.pointA[i].rn, cM.pointA[i].rn)) +
-                (invInertiaB * dot(cM.pointB[i].rn, cM.pointB[i].rn));
+                dot(pointA.rb, bodyA->invInertiaMul(pointA.rb)) +
+                dot(pointB.rb, bodyB->invInertiaMul(pointB.rb));
+        cM.infoPoint[i].kPseudo = 2.0f + angularNormal;
 	}
-#endif
 }
 
 void Solver::preSolve_static(ContactManifold& cM, Body* bodyA)
 {
 	cM.solved = false;
-	int i;
     float invMassSum = bodyA->m_invMass;
-#if (BodyInertia)
-    Vector3 invInertiaA = bodyA->m_invInertia;
-    for (i = 0; i < cM.countPoints; ++i) {
-        cM.infoPoint[i].kNormal = invMassSum +
-                (dot(cM.pointA[i].rn, Vector3(cM.pointA[i].rn.x * invInertiaA.x,
-                                              cM.pointA[i].rn.y * invInertiaA.y,
-                                              cM.pointA[i].rn.z * invInertiaA.z)));
-        cM.infoPoint[i].kBinormal = invMassSum +
-                (dot(cM.pointA[i].rb, Vector3(cM.pointA[i].rb.x * invInertiaA.x,
-                                              cM.pointA[i].rb.y * invInertiaA.y,
-                                              cM.pointA[i].rb.z * invInertiaA.z)));
-        cM.infoPoint[i].kPseudo = 2.0f + (dot(cM.pointA[i].rb, Vector3(cM.pointA[i].rb.x * invInertiaA.x,
-                                                                       cM.pointA[i].rb.y * invInertiaA.y,
-                                                                       cM.pointA[i].rb.z * invInertiaA.z)));
-	}
-#else
-    float invInertiaA = bodyA->m_invInertia;
-    for (i = 0; i < cM.countPoints; ++i) {
-        cM.infoPoint[i].kNormal = invMassSum + (invInertiaA * dot(cM.pointA[i].rn, cM.pointA[i].rn));
-        cM.infoPoint[i].kBinormal = invMassSum + (invInertiaA * dot(cM.pointA[i].rb, cM.pointA[i].rb));
-        cM.infoPoint[i].kPseudo = 1.0f + (invInertiaA * dot(cM.pointA[i].rn, cM.pointA[i].rn));
+    for (int i = 0; i < cM.countPoints; ++i) {
+        const R_ContactPoint& pointA = cM.pointA[i];
+        float angularNormal = dot(pointA.rn, bodyA->invInertiaMul(pointA.rn));
+        cM.infoPoint[i].kNormal = invMassSum + angularNormal;
+        cM.infoPoint[i].kBinormal = invMassSum + dot(pointA.rb, bodyA->invInertiaMul(pointA.rb));
+        cM.infoPoint[i].kPseudo = 1.0f + angularNormal;
 	}
-#endif
 }
 
 void Solver::solveImpulse(float e, Body* bodyA, Body* bodyB, const Vector3& normal, const R_ContactPoint& cPA,
@@ -197,74 +294,665 @@ void Solver::solvePseudoImpulse_static(Body* bodyA, const Vector3& normal, const
 	bodyA->applyAngularPseudoImpulse(cPA.rn, pseudoImpulse);
 }
 
-void Solver::preSolve()
+void Solver::preSolve(SolverContext& context, const Island& island)
 {
+    std::size_t i, k, row;
     int j;
-    for (std::size_t i = 0; i < m_contactManifolds.size(); ++i) {
-        ContactManifold& cm = m_contactManifolds[i];
+    context.solverBodies.resize(1);
+    SolverBody& staticBody = context.solverBodies[0];
+    staticBody.velocity = staticBody.angularVelocity = Vector3(0.0f, 0.0f, 0.0f);
+    staticBody.pseudoVelocity = staticBody.pseudoAngularVelocity = Vector3(0.0f, 0.0f, 0.0f);
+    staticBody.invMass = 0.0f;
+    staticBody.pseudoInvMass = 0.0f;
+#if (PE_BodyInertia == 3)
+    staticBody.invInertia = Matrix3(0.0f);
+#else
+    staticBody.invInertia = 0.0f;
+#endif
+    staticBody.body = nullptr;
+    context.constraintSlots.resize(0);
+    context.batchSizes.resize(0);
+    context.bodyBatches.assign(1, 0);
+    context.firstOpenBatch = 0;
+    context.colorGroups.resize(0);
+    context.manifoldRows.resize(0);
+    bool colored = m_enableColoring && (m_contexts.size() > 1) && (island.countManifolds >= PE_SolverColoringMinManifolds);
+    std::uint32_t indexA, indexB;
+    for (k = 0; k < island.countManifolds; ++k) {
+        ContactManifold& cm = m_contactManifolds[m_islandManifolds[island.firstManifold + k]];
         if (cm.notStatB) {
-            cm.bodyA->_mergeCollisionGroup(cm.bodyB);
             preSolve(cm, cm.bodyA, cm.bodyB);
-            for (j = 0; j < cm.countPoints; ++j) {
-                solveImpulse(cm.e, cm.bodyA, cm.bodyB, cm.normal, cm.pointA[j], cm.pointB[j], cm.infoPoint[j]);
-                solveImpulseFriction(cm.mu, cm.bodyA, cm.bodyB, cm.pointA[j], cm.pointB[j], cm.infoPoint[j]);
-            }
         } else {
             preSolve_static(cm, cm.bodyA);
-            for (j = 0; j < cm.countPoints; ++j) {
-                solveImpulse_static(cm.e, cm.bodyA, cm.normal, cm.pointA[j], cm.infoPoint[j]);
-                solveImpulseFriction_static(cm.mu, cm.bodyA, cm.pointA[j], cm.infoPoint[j]);
-            }
+        }
+        indexA = _solverBodyIndex(context, cm.bodyA);
+        indexB = cm.notStatB ? _solverBodyIndex(context, cm.bodyB) : 0;
+        if (colored)
+            continue;
+        context.manifoldRows.push_back(context.constraintSlots.size());
+        for (j = 0; j < cm.countPoints; ++j) {
+#if (PE_SolverSIMD)
+            context.constraintSlots.push_back(_constraintSlot(context, indexA, indexB));
+#else
+            context.constraintSlots.push_back(context.constraintSlots.size());
+#endif
+        }
+    }
+    if (colored) {
+        _colorConstraints(context, island);
+    } else {
+        context.manifoldRows.push_back(context.constraintSlots.size());
+#if (PE_SolverSIMD)
+        context.constraints.resize(context.batchSizes.size() * PE_SolverSIMDWidth);
+        for (i = 0; i < context.batchSizes.size(); ++i) {
+            for (k = context.batchSizes[i]; k < PE_SolverSIMDWidth; ++k)
+                context.constraints.setEmpty(i * PE_SolverSIMDWidth + k);
+        }
+#else
+        context.constraints.resize(context.constraintSlots.size());
+#endif
+    }
+    row = 0;
+    for (k = 0; k < island.countManifolds; ++k) {
+        i = m_islandManifolds[island.firstManifold + k];
+        const ContactManifold& cm = m_contactManifolds[i];
+        indexA = cm.bodyA->m_solverIndex;
+        indexB = cm.notStatB ? cm.bodyB->m_solverIndex : 0;
+        const SolverBody& solverBodyA = context.solverBodies[indexA];
+        const SolverBody& solverBodyB = context.solverBodies[indexB];
+        for (j = 0; j < cm.countPoints; ++j, ++row) {
+            const InfoPointOnCM& info = cm.infoPoint[j];
+            std::size_t slot = context.constraintSlots[row];
+            context.constraints.manifold[slot] = (int)i;
+            context.constraints.point[slot] = j;
+            context.constraints.bodyA[slot] = indexA;
+            context.constraints.bodyB[slot] = indexB;
+            context.constraints.normal[slot] = cm.normal;
+            context.constraints.binormal[slot] = info.binormal;
+            context.constraints.rnA[slot] = cm.pointA[j].rn;
+            context.constraints.rbA[slot] = cm.pointA[j].rb;
+            context.constraints.rnB[slot] = cm.pointB[j].rn;
+            context.constraints.rbB[slot] = cm.pointB[j].rb;
+            context.constraints.invInertiaRnA[slot] = solverBodyA.invInertiaMul(cm.pointA[j].rn);
+            context.constraints.invInertiaRbA[slot] = solverBodyA.invInertiaMul(cm.pointA[j].rb);
+            context.constraints.invInertiaRnB[slot] = solverBodyB.invInertiaMul(cm.pointB[j].rn);
+            context.constraints.invInertiaRbB[slot] = solverBodyB.invInertiaMul(cm.pointB[j].rb);
+            context.constraints.e[slot] = cm.e;
+            context.constraints.mu[slot] = cm.mu;
+            context.constraints.depthA[slot] = info.depthA;
+            context.constraints.depthB[slot] = info.depthB;
+            context.constraints.kNormal[slot] = info.kNormal;
+            context.constraints.kBinormal[slot] = info.kBinormal;
+            context.constraints.kPseudo[slot] = info.kPseudo;
+            context.constraints.impulse[slot] = info.impulse;
+            context.constraints.impulseFriction[slot] = info.impulseFriction;
+            context.constraints.pseudoImpulse[slot] = info.pseudoImpulse;
+        }
+    }
+}
+
+float Solver::solveContacts(SolverContext& context)
+{
+    if (m_enableBlockSolver)
+        return _solveBlockContacts(context);
+    std::size_t count = context.constraints.count();
+    float residual = 0.0f;
+#if (PE_SolverSIMD)
+    for (std::size_t i = 0; i < count; i += PE_SolverSIMDWidth) {
+        residual = std::max(residual, _solveImpulseBatch(context, i));
+        residual = std::max(residual, _solveImpulseFrictionBatch(context, i));
+    }
+#else
+    for (std::size_t i = 0; i < count; ++i) {
+        residual = std::max(residual, _solveImpulse(context, i));
+        residual = std::max(residual, _solveImpulseFriction(context, i));
+    }
+#endif
+    return residual;
+}
+
+float Solver::solvePseudoContacts(SolverContext& context)
+{
+    std::size_t count = context.constraints.count();
+    float residual = 0.0f;
+#if (PE_SolverSIMD)
+    for (std::size_t i = 0; i < count; i += PE_SolverSIMDWidth)
+        residual = std::max(residual, _solvePseudoImpulseBatch(context, i));
+#else
+    for (std::size_t i = 0; i < count; ++i)
+        residual = std::max(residual, _solvePseudoImpulse(context, i));
+#endif
+    return residual;
+}
+
+void Solver::storeImpulses(SolverContext& context)
+{
+    std::size_t count = context.constraints.count();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (context.constraints.manifold[i] < 0)
+            continue;
+        InfoPointOnCM& info = m_contactManifolds[context.constraints.manifold[i]].infoPoint[context.constraints.point[i]];
+        info.impulse = context.constraints.impulse[i];
+        info.impulseFriction = context.constraints.impulseFriction[i];
+        info.pseudoImpulse = context.constraints.pseudoImpulse[i];
+    }
+}
+
+void Solver::solve()
+{
+    std::size_t i;
+    if (m_contexts.size() == 1) {
+        for (i = 0; i < m_islands.size(); ++i)
+            solveIsland(m_contexts[0], m_islands[i]);
+        return;
+    }
+    _scheduleIslands();
+    for (i = 0; i < m_countLargeIslands; ++i)
+        solveIsland(m_contexts[0], m_islands[m_islandOrder[i]]);
+    if (m_islandTasks.size() < 2)
+        return;
+    std::atomic<std::size_t> nextTask(0);
+    m_threadPool.run([this, &nextTask] (int threadIndex) {
+        SolverContext& context = m_contexts[threadIndex];
+        for (std::size_t task = nextTask++; task + 1 < m_islandTasks.size(); task = nextTask++) {
+            for (std::size_t i = m_islandTasks[task]; i < m_islandTasks[task + 1]; ++i)
+                solveIsland(context, m_islands[m_islandOrder[i]]);
+        }
+    });
+}
+
+void Solver::resetScratchArenas()
+{
+    for (auto it = m_contexts.begin(); it != m_contexts.end(); ++it)
+        it->scratch.reset();
+}
+
+void Solver::_scheduleIslands()
+{
+    std::size_t i, countManifolds = 0;
+    m_islandOrder.resize(m_islands.size());
+    for (i = 0; i < m_islandOrder.size(); ++i)
+        m_islandOrder[i] = i;
+    std::sort(m_islandOrder.begin(), m_islandOrder.end(), [this] (std::size_t a, std::size_t b) {
+        return (m_islands[a].countManifolds > m_islands[b].countManifolds);
+    });
+    m_countLargeIslands = 0;
+    while ((m_countLargeIslands < m_islandOrder.size()) &&
+           (m_islands[m_islandOrder[m_countLargeIslands]].countManifolds >= PE_SolverColoringMinManifolds))
+        ++m_countLargeIslands;
+    m_islandTasks.assign(1, m_countLargeIslands);
+    for (i = m_countLargeIslands; i < m_islandOrder.size(); ++i) {
+        countManifolds += m_islands[m_islandOrder[i]].countManifolds;
+        if (countManifolds >= PE_SolverIslandBatchSize) {
+            m_islandTasks.push_back(i + 1);
+            countManifolds = 0;
         }
     }
+    if (countManifolds > 0)
+        m_islandTasks.push_back(m_islandOrder.size());
 }
 
-void Solver::solveContacts()
+void Solver::solveIsland(SolverContext& context, Island& island)
 {
+    preSolve(context, island);
+    if (!context.colorGroups.empty()) {
+        _solveColoredContacts(context, island);
+    } else {
+        island.countIterations = 0;
+        while (island.countIterations < m_solverCountIterations) {
+            ++island.countIterations;
+            if (solveContacts(context) < m_residualTolerance)
+                break;
+        }
+        island.countSplitImpulsesIterations = 0;
+        while (island.countSplitImpulsesIterations < m_splitImpulsesIterations) {
+            ++island.countSplitImpulsesIterations;
+            if (solvePseudoContacts(context) < m_residualTolerance)
+                break;
+        }
+    }
+    storeImpulses(context);
+    storeSolverBodies(context);
+}
+
+void Solver::storeSolverBodies(SolverContext& context)
+{
+    for (std::size_t i = 1; i < context.solverBodies.size(); ++i) {
+        const SolverBody& solverBody = context.solverBodies[i];
+        Body* body = solverBody.body;
+        body->m_velocity = solverBody.velocity;
+        body->m_angularVelocity = solverBody.angularVelocity;
+        body->m_pseudoVelocity = solverBody.pseudoVelocity;
+        body->m_pseudoAngularVelocity = solverBody.pseudoAngularVelocity;
+        body->m_solverIndex = 0;
+    }
+    context.solverBodies.resize(1);
+}
+
+std::uint32_t Solver::_solverBodyIndex(SolverContext& context, Body* body)
+{
+    if (body->isStatic())
+        return 0;
+    if (body->m_solverIndex == 0) {
+        SolverBody solverBody;
+        solverBody.velocity = body->m_velocity;
+        solverBody.angularVelocity = body->m_angularVelocity;
+        solverBody.pseudoVelocity = body->m_pseudoVelocity;
+        solverBody.pseudoAngularVelocity = body->m_pseudoAngularVelocity;
+        solverBody.invMass = body->m_invMass;
+        solverBody.pseudoInvMass = 1.0f;
+#if (PE_BodyInertia == 3)
+        solverBody.invInertia = body->m_worldInvInertia;
+#else
+        solverBody.invInertia = body->m_invInertia;
+#endif
+        solverBody.body = body;
+        body->m_solverIndex = (std::uint32_t)context.solverBodies.size();
+        context.solverBodies.push_back(solverBody);
+        context.bodyBatches.push_back(0);
+    }
+    return body->m_solverIndex;
+}
+
+void Solver::_colorConstraints(SolverContext& context, const Island& island)
+{
+    std::size_t k, c, l, countColors = 0, countRows = 0;
     int j;
-    for (std::size_t i = 0; i < m_contactManifolds.size(); ++i) {
-        ContactManifold& cm = m_contactManifolds[i];
-        if (cm.notStatB) {
-            cm.bodyA->_mergeCollisionGroup(cm.bodyB);
-            for (j = 0; j < cm.countPoints; ++j) {
-                solveImpulse(cm.e, cm.bodyA, cm.bodyB, cm.normal, cm.pointA[j], cm.pointB[j], cm.infoPoint[j]);
-                solveImpulseFriction(cm.mu, cm.bodyA, cm.bodyB, cm.pointA[j], cm.pointB[j], cm.infoPoint[j]);
+    context.bodyColors.assign(context.solverBodies.size(), 0);
+    context.manifoldColors.resize(island.countManifolds);
+    context.manifoldRows.resize(island.countManifolds);
+    for (k = 0; k < island.countManifolds; ++k) {
+        const ContactManifold& cm = m_contactManifolds[m_islandManifolds[island.firstManifold + k]];
+        std::uint32_t indexA = cm.bodyA->m_solverIndex;
+        std::uint32_t indexB = cm.notStatB ? cm.bodyB->m_solverIndex : 0;
+        std::uint64_t used = context.bodyColors[indexA] | context.bodyColors[indexB];
+        for (c = 0; (c < PE_SolverMaxColors) && ((used >> c) & 1); ++c);
+        if (c < PE_SolverMaxColors) {
+            context.bodyColors[indexA] |= (std::uint64_t)1 << c;
+            if (indexB != 0)
+                context.bodyColors[indexB] |= (std::uint64_t)1 << c;
+        }
+        context.manifoldColors[k] = (std::uint32_t)c;
+        countColors = std::max(countColors, c + 1);
+        context.manifoldRows[k] = countRows;
+        countRows += cm.countPoints;
+    }
+    std::vector<std::size_t>& colorManifolds = context.coloredManifolds;
+    ScratchScope scratchScope(context.scratch);
+    std::size_t* colorStarts = context.scratch.allocate<std::size_t>(countColors + 1);
+    std::fill(colorStarts, colorStarts + countColors + 1, 0);
+    for (k = 0; k < island.countManifolds; ++k)
+        ++colorStarts[context.manifoldColors[k] + 1];
+    for (c = 0; c < countColors; ++c)
+        colorStarts[c + 1] += colorStarts[c];
+    colorManifolds.resize(island.countManifolds);
+    std::size_t* cursors = context.scratch.allocate<std::size_t>(countColors);
+    std::copy(colorStarts, colorStarts + countColors, cursors);
+    for (k = 0; k < island.countManifolds; ++k)
+        colorManifolds[cursors[context.manifoldColors[k]]++] = k;
+    context.constraintSlots.resize(countRows);
+    context.colorGroups.assign(1, 0);
+    context.groupBatches.assign(1, 0);
+    for (c = 0; c < countColors; ++c) {
+        // Manifolds that did not get a color may share bodies, so they get a group each and run on one thread.
+        std::size_t countLanes = (c < PE_SolverMaxColors) ? PE_SOLVER_LANES : 1;
+        for (k = colorStarts[c]; k < colorStarts[c + 1]; k += countLanes) {
+            std::size_t firstBatch = context.groupBatches.back();
+            int countBatches = 0;
+            for (l = 0; (l < countLanes) && (k + l < colorStarts[c + 1]); ++l) {
+                std::size_t index = colorManifolds[k + l];
+                const ContactManifold& cm = m_contactManifolds[m_islandManifolds[island.firstManifold + index]];
+                for (j = 0; j < cm.countPoints; ++j)
+                    context.constraintSlots[context.manifoldRows[index] + j] = (firstBatch + j) * PE_SOLVER_LANES + l;
+                countBatches = std::max(countBatches, cm.countPoints);
             }
-        } else {
-            for (j = 0; j < cm.countPoints; ++j) {
-                solveImpulse_static(cm.e, cm.bodyA, cm.normal, cm.pointA[j], cm.infoPoint[j]);
-                solveImpulseFriction_static(cm.mu, cm.bodyA, cm.pointA[j], cm.infoPoint[j]);
+            context.groupBatches.push_back(firstBatch + countBatches);
+        }
+        context.colorGroups.push_back(context.groupBatches.size() - 1);
+    }
+    std::size_t countSlots = context.groupBatches.back() * PE_SOLVER_LANES;
+    context.constraints.resize(countSlots);
+    for (k = 0; k < countSlots; ++k)
+        context.constraints.setEmpty(k);
+}
+
+void Solver::_solveColoredContacts(SolverContext& context, Island& island)
+{
+    int countThreads = m_threadPool.countThreads();
+    ThreadBarrier barrier(countThreads);
+    // Two sets of per-thread residuals alternate by pass, so a thread starting the next pass doesn't clear a value
+    // still being read. The pass counter runs on through the split-impulse loop to keep the alternation.
+    context.threadResiduals.assign(2 * countThreads, 0.0f);
+    m_threadPool.run([this, &context, &island, &barrier, countThreads] (int threadIndex) {
+        int i, pass = 0;
+        for (i = 0; i < m_solverCountIterations; ++i) {
+            if (_solveColors(context, barrier, pass++, threadIndex, countThreads, false) < m_residualTolerance) {
+                ++i;
+                break;
+            }
+        }
+        if (threadIndex == 0)
+            island.countIterations = i;
+        for (i = 0; i < m_splitImpulsesIterations; ++i) {
+            if (_solveColors(context, barrier, pass++, threadIndex, countThreads, true) < m_residualTolerance) {
+                ++i;
+                break;
             }
         }
+        if (threadIndex == 0)
+            island.countSplitImpulsesIterations = i;
+    });
+}
+
+float Solver::_solveColors(SolverContext& context, ThreadBarrier& barrier, int pass,
+                           int threadIndex, int countThreads, bool pseudo)
+{
+    float* residuals = &context.threadResiduals[(pass % 2) * countThreads];
+    residuals[threadIndex] = 0.0f;
+    for (std::size_t c = 0; c + 1 < context.colorGroups.size(); ++c) {
+        residuals[threadIndex] = std::max(residuals[threadIndex],
+                                          _solveColor(context, c, threadIndex, countThreads, pseudo));
+        barrier.wait();
     }
+    return *std::max_element(residuals, residuals + countThreads);
 }
 
-void Solver::solvePseudoContacts()
+float Solver::_solveColor(SolverContext& context, std::size_t color, int threadIndex, int countThreads, bool pseudo)
 {
-    int j;
-    for (std::size_t i = 0; i < m_contactManifolds.size(); ++i) {
-        ContactManifold& cm = m_contactManifolds[i];
-        if (cm.notStatB) {
-            cm.bodyA->_mergeCollisionGroup(cm.bodyB);
-            for (j = 0; j < cm.countPoints; ++j) {
-                solvePseudoImpulse(cm.bodyA, cm.bodyB, cm.normal, cm.pointA[j], cm.pointB[j], cm.infoPoint[j]);
+    float residual = 0.0f;
+    std::size_t first = context.colorGroups[color], end = context.colorGroups[color + 1], step = countThreads;
+    if (color >= PE_SolverMaxColors) {
+        if (threadIndex != 0)
+            return residual;
+        step = 1;
+    } else {
+        first += threadIndex;
+    }
+    for (std::size_t g = first; g < end; g += step) {
+        for (std::size_t b = context.groupBatches[g]; b < context.groupBatches[g + 1]; ++b) {
+            std::size_t i = b * PE_SOLVER_LANES;
+#if (PE_SolverSIMD)
+            if (pseudo) {
+                residual = std::max(residual, _solvePseudoImpulseBatch(context, i));
+            } else {
+                residual = std::max(residual, _solveImpulseBatch(context, i));
+                residual = std::max(residual, _solveImpulseFrictionBatch(context, i));
             }
-        } else {
-            for (j = 0; j < cm.countPoints; ++j) {
-                solvePseudoImpulse_static(cm.bodyA, cm.normal, cm.pointA[j], cm.infoPoint[j]);
+#else
+            if (pseudo) {
+                residual = std::max(residual, _solvePseudoImpulse(context, i));
+            } else {
+                residual = std::max(residual, _solveImpulse(context, i));
+                residual = std::max(residual, _solveImpulseFriction(context, i));
             }
+#endif
         }
     }
+    return residual;
 }
 
-void Solver::solve()
+std::size_t Solver::_constraintSlot(SolverContext& context, std::uint32_t indexA, std::uint32_t indexB)
+{
+    std::size_t batch = std::max(context.firstOpenBatch, std::max(context.bodyBatches[indexA], context.bodyBatches[indexB]));
+    while ((batch < context.batchSizes.size()) && (context.batchSizes[batch] == PE_SolverSIMDWidth))
+        ++batch;
+    if (batch == context.batchSizes.size())
+        context.batchSizes.push_back(0);
+    std::size_t slot = batch * PE_SolverSIMDWidth + context.batchSizes[batch];
+    ++context.batchSizes[batch];
+    if (indexA != 0)
+        context.bodyBatches[indexA] = batch + 1;
+    if (indexB != 0)
+        context.bodyBatches[indexB] = batch + 1;
+    while ((context.firstOpenBatch < context.batchSizes.size()) && (context.batchSizes[context.firstOpenBatch] == PE_SolverSIMDWidth))
+        ++context.firstOpenBatch;
+    return slot;
+}
+
+float Solver::_solveBlockContacts(SolverContext& context)
+{
+    float residual = 0.0f;
+    for (std::size_t k = 0; k + 1 < context.manifoldRows.size(); ++k) {
+        residual = std::max(residual, _solveBlockImpulse(context, k));
+        for (std::size_t row = context.manifoldRows[k]; row < context.manifoldRows[k + 1]; ++row)
+            residual = std::max(residual, _solveImpulseFriction(context, context.constraintSlots[row]));
+    }
+    return residual;
+}
+
+float Solver::_solveBlockImpulse(SolverContext& context, std::size_t k)
 {
-	int i;
-    preSolve();
-    for (i = 1; i < m_solverCountIterations; ++i)
-        solveContacts();
-    for (i = 0; i < m_splitImpulsesIterations; ++i)
-        solvePseudoContacts();
+    ContactConstraints& constraints = context.constraints;
+    const std::size_t* slots = &context.constraintSlots[context.manifoldRows[k]];
+    int i, j, n = (int)(context.manifoldRows[k + 1] - context.manifoldRows[k]);
+    if (n == 1)
+        return _solveImpulse(context, slots[0]);
+    SolverBody& bodyA = context.solverBodies[constraints.bodyA[slots[0]]];
+    SolverBody& bodyB = context.solverBodies[constraints.bodyB[slots[0]]];
+    const Vector3& normal = constraints.normal[slots[0]];
+    float a[PE_MaxCountContactManifoldPoints][PE_MaxCountContactManifoldPoints];
+    float q[PE_MaxCountContactManifoldPoints], x[PE_MaxCountContactManifoldPoints];
+    float invMassSum = bodyA.invMass + bodyB.invMass;
+    for (i = 0; i < n; ++i) {
+        std::size_t slot = slots[i];
+        const Vector3& invInertiaRnA = constraints.invInertiaRnA[slot];
+        const Vector3& invInertiaRnB = constraints.invInertiaRnB[slot];
+        for (j = 0; j < n; ++j)
+            a[i][j] = invMassSum + dot(invInertiaRnA, constraints.rnA[slots[j]]) +
+                    dot(invInertiaRnB, constraints.rnB[slots[j]]);
+        float nVelProj = dot(bodyA.velocity - bodyB.velocity, normal) +
+                         dot(bodyA.angularVelocity, constraints.rnA[slot]) -
+                         dot(bodyB.angularVelocity, constraints.rnB[slot]);
+        q[i] = constraints.e[slot] * nVelProj - constraints.depthA[slot];
+    }
+    for (i = 0; i < n; ++i) {
+        for (j = 0; j < n; ++j)
+            q[i] -= a[i][j] * constraints.impulse[slots[j]];
+    }
+    // Four coplanar points make the matrix singular. A small diagonal term pulling towards the previous
+    // impulses keeps all points loaded evenly and vanishes once the impulses stop changing.
+    for (i = 0; i < n; ++i) {
+        q[i] -= 0.01f * a[i][i] * constraints.impulse[slots[i]];
+        a[i][i] *= 1.01f;
+    }
+    // Finds accumulated impulses x >= 0 with a*x + q >= 0 and zero where x > 0.
+    int mask;
+    for (mask = (1 << n) - 1; mask >= 0; --mask) {
+        if (solveContactSubset(a, q, n, mask, x))
+            break;
+    }
+    if (mask < 0) {
+        float residual = 0.0f;
+        for (i = 0; i < n; ++i)
+            residual = std::max(residual, _solveImpulse(context, slots[i]));
+        return residual;
+    }
+    float residual = 0.0f;
+    for (i = 0; i < n; ++i) {
+        std::size_t slot = slots[i];
+        float impulse = x[i] - constraints.impulse[slot];
+        constraints.impulse[slot] = x[i];
+        bodyA.applyImpulse(normal, constraints.invInertiaRnA[slot], impulse);
+        if (constraints.bodyB[slot] != 0)
+            bodyB.applyImpulse(normal, constraints.invInertiaRnB[slot], - impulse);
+        residual = std::max(residual, std::fabs(impulse));
+    }
+    return residual;
+}
+
+float Solver::_solveImpulse(SolverContext& context, std::size_t i)
+{
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    SolverBody& bodyA = solverBodies[constraints.bodyA[i]];
+    SolverBody& bodyB = solverBodies[constraints.bodyB[i]];
+    const Vector3& normal = constraints.normal[i];
+    const Vector3& rnA = constraints.rnA[i];
+    const Vector3& rnB = constraints.rnB[i];
+    float nVelProj = dot(bodyA.velocity - bodyB.velocity, normal) +
+                     dot(bodyA.angularVelocity, rnA) - dot(bodyB.angularVelocity, rnB),
+          impulse;
+    impulse = (constraints.depthA[i] - constraints.e[i] * nVelProj) / constraints.kNormal[i];
+    float& accumulated = constraints.impulse[i];
+    accumulated += impulse;
+    if (accumulated < 0.0f) {
+        impulse -= accumulated;
+        accumulated = 0.0f;
+    }
+    bodyA.applyImpulse(normal, constraints.invInertiaRnA[i], impulse);
+    if (constraints.bodyB[i] != 0)
+        bodyB.applyImpulse(normal, constraints.invInertiaRnB[i], - impulse);
+    return std::fabs(impulse);
+}
+
+float Solver::_solveImpulseFriction(SolverContext& context, std::size_t i)
+{
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    SolverBody& bodyA = solverBodies[constraints.bodyA[i]];
+    SolverBody& bodyB = solverBodies[constraints.bodyB[i]];
+    const Vector3& binormal = constraints.binormal[i];
+    const Vector3& rbA = constraints.rbA[i];
+    const Vector3& rbB = constraints.rbB[i];
+    float nVelProj = dot(bodyA.velocity - bodyB.velocity, binormal) +
+                     dot(bodyA.angularVelocity, rbA) - dot(bodyB.angularVelocity, rbB);
+    float impulseMax = constraints.impulse[i] * constraints.mu[i];
+    float& accumulated = constraints.impulseFriction[i];
+    float old = accumulated;
+    accumulated = std::max(- impulseMax, std::min(old - nVelProj / constraints.kBinormal[i], impulseMax));
+    float impulseFriction = accumulated - old;
+    bodyA.applyImpulse(binormal, constraints.invInertiaRbA[i], impulseFriction);
+    if (constraints.bodyB[i] != 0)
+        bodyB.applyImpulse(binormal, constraints.invInertiaRbB[i], - impulseFriction);
+    return std::fabs(impulseFriction);
+}
+
+float Solver::_solvePseudoImpulse(SolverContext& context, std::size_t i)
+{
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    SolverBody& bodyA = solverBodies[constraints.bodyA[i]];
+    SolverBody& bodyB = solverBodies[constraints.bodyB[i]];
+    const Vector3& normal = constraints.normal[i];
+    const Vector3& rnA = constraints.rnA[i];
+    const Vector3& rnB = constraints.rnB[i];
+    float nVelProj = dot(bodyA.pseudoVelocity - bodyB.pseudoVelocity, normal) +
+                     dot(bodyA.pseudoAngularVelocity, rnA) - dot(bodyB.pseudoAngularVelocity, rnB),
+          pseudoImpulse;
+    pseudoImpulse = (constraints.depthB[i] - nVelProj) / constraints.kPseudo[i];
+    float& accumulated = constraints.pseudoImpulse[i];
+    accumulated += pseudoImpulse;
+    if (accumulated < 0.0f) {
+        pseudoImpulse -= accumulated;
+        accumulated = 0.0f;
+    }
+    bodyA.applyPseudoImpulse(normal, constraints.invInertiaRnA[i], pseudoImpulse);
+    if (constraints.bodyB[i] != 0)
+        bodyB.applyPseudoImpulse(normal, constraints.invInertiaRnB[i], - pseudoImpulse);
+    return std::fabs(pseudoImpulse);
+}
+
+float Solver::_solveImpulseBatch(SolverContext& context, std::size_t i)
+{
+#if defined(PE_SOLVER_SSE2)
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    const std::uint32_t* indicesA = &constraints.bodyA[i];
+    const std::uint32_t* indicesB = &constraints.bodyB[i];
+    Vector3x4 normal = Vector3x4::load(&constraints.normal[i]);
+    Vector3x4 rnA = Vector3x4::load(&constraints.rnA[i]);
+    Vector3x4 rnB = Vector3x4::load(&constraints.rnB[i]);
+    __m128 nVelProj = _mm_sub_ps(_mm_add_ps(dot(gatherSolverBodies(solverBodies, indicesA, &SolverBody::velocity) -
+                                                 gatherSolverBodies(solverBodies, indicesB, &SolverBody::velocity), normal),
+                                             dot(gatherSolverBodies(solverBodies, indicesA, &SolverBody::angularVelocity), rnA)),
+                                  dot(gatherSolverBodies(solverBodies, indicesB, &SolverBody::angularVelocity), rnB));
+    __m128 impulse = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(&constraints.depthA[i]),
+                                           _mm_mul_ps(_mm_loadu_ps(&constraints.e[i]), nVelProj)),
+                                _mm_loadu_ps(&constraints.kNormal[i]));
+    __m128 old = _mm_loadu_ps(&constraints.impulse[i]);
+    __m128 accumulated = _mm_max_ps(_mm_add_ps(old, impulse), _mm_setzero_ps());
+    _mm_storeu_ps(&constraints.impulse[i], accumulated);
+    impulse = _mm_sub_ps(accumulated, old);
+    scatterSolverBodies(solverBodies, indicesA, &SolverBody::velocity, &SolverBody::angularVelocity,
+                        &SolverBody::invMass, normal, Vector3x4::load(&constraints.invInertiaRnA[i]), impulse);
+    scatterSolverBodies(solverBodies, indicesB, &SolverBody::velocity, &SolverBody::angularVelocity,
+                        &SolverBody::invMass, normal, Vector3x4::load(&constraints.invInertiaRnB[i]),
+                        _mm_sub_ps(_mm_setzero_ps(), impulse));
+    return horizontalMaxAbs(impulse);
+#else
+    float residual = 0.0f;
+    for (std::size_t k = i; k < i + PE_SolverSIMDWidth; ++k)
+        residual = std::max(residual, _solveImpulse(context, k));
+    return residual;
+#endif
+}
+
+float Solver::_solveImpulseFrictionBatch(SolverContext& context, std::size_t i)
+{
+#if defined(PE_SOLVER_SSE2)
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    const std::uint32_t* indicesA = &constraints.bodyA[i];
+    const std::uint32_t* indicesB = &constraints.bodyB[i];
+    Vector3x4 binormal = Vector3x4::load(&constraints.binormal[i]);
+    Vector3x4 rbA = Vector3x4::load(&constraints.rbA[i]);
+    Vector3x4 rbB = Vector3x4::load(&constraints.rbB[i]);
+    __m128 nVelProj = _mm_sub_ps(_mm_add_ps(dot(gatherSolverBodies(solverBodies, indicesA, &SolverBody::velocity) -
+                                                 gatherSolverBodies(solverBodies, indicesB, &SolverBody::velocity), binormal),
+                                             dot(gatherSolverBodies(solverBodies, indicesA, &SolverBody::angularVelocity), rbA)),
+                                  dot(gatherSolverBodies(solverBodies, indicesB, &SolverBody::angularVelocity), rbB));
+    __m128 impulseMax = _mm_mul_ps(_mm_loadu_ps(&constraints.impulse[i]), _mm_loadu_ps(&constraints.mu[i]));
+    __m128 old = _mm_loadu_ps(&constraints.impulseFriction[i]);
+    __m128 accumulated = _mm_sub_ps(old, _mm_div_ps(nVelProj, _mm_loadu_ps(&constraints.kBinormal[i])));
+    accumulated = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), impulseMax), _mm_min_ps(accumulated, impulseMax));
+    _mm_storeu_ps(&constraints.impulseFriction[i], accumulated);
+    __m128 impulseFriction = _mm_sub_ps(accumulated, old);
+    scatterSolverBodies(solverBodies, indicesA, &SolverBody::velocity, &SolverBody::angularVelocity,
+                        &SolverBody::invMass, binormal, Vector3x4::load(&constraints.invInertiaRbA[i]), impulseFriction);
+    scatterSolverBodies(solverBodies, indicesB, &SolverBody::velocity, &SolverBody::angularVelocity,
+                        &SolverBody::invMass, binormal, Vector3x4::load(&constraints.invInertiaRbB[i]),
+                        _mm_sub_ps(_mm_setzero_ps(), impulseFriction));
+    return horizontalMaxAbs(impulseFriction);
+#else
+    float residual = 0.0f;
+    for (std::size_t k = i; k < i + PE_SolverSIMDWidth; ++k)
+        residual = std::max(residual, _solveImpulseFriction(context, k));
+    return residual;
+#endif
+}
+
+float Solver::_solvePseudoImpulseBatch(SolverContext& context, std::size_t i)
+{
+#if defined(PE_SOLVER_SSE2)
+    ContactConstraints& constraints = context.constraints;
+    std::vector<SolverBody>& solverBodies = context.solverBodies;
+    const std::uint32_t* indicesA = &constraints.bodyA[i];
+    const std::uint32_t* indicesB = &constraints.bodyB[i];
+    Vector3x4 normal = Vector3x4::load(&constraints.normal[i]);
+    Vector3x4 rnA = Vector3x4::load(&constraints.rnA[i]);
+    Vector3x4 rnB = Vector3x4::load(&constraints.rnB[i]);
+    __m128 nVelProj = _mm_sub_ps(_mm_add_ps(dot(gatherSolverBodies(solverBodies, indicesA, &SolverBody::pseudoVelocity) -
+                                                 gatherSolverBodies(solverBodies, indicesB, &SolverBody::pseudoVelocity), normal),
+                                             dot(gatherSolverBodies(solverBodies, indicesA, &SolverBody::pseudoAngularVelocity), rnA)),
+                                  dot(gatherSolverBodies(solverBodies, indicesB, &SolverBody::pseudoAngularVelocity), rnB));
+    __m128 pseudoImpulse = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(&constraints.depthB[i]), nVelProj),
+                                      _mm_loadu_ps(&constraints.kPseudo[i]));
+    __m128 old = _mm_loadu_ps(&constraints.pseudoImpulse[i]);
+    __m128 accumulated = _mm_max_ps(_mm_add_ps(old, pseudoImpulse), _mm_setzero_ps());
+    _mm_storeu_ps(&constraints.pseudoImpulse[i], accumulated);
+    pseudoImpulse = _mm_sub_ps(accumulated, old);
+    scatterSolverBodies(solverBodies, indicesA, &SolverBody::pseudoVelocity, &SolverBody::pseudoAngularVelocity,
+                        &SolverBody::pseudoInvMass, normal, Vector3x4::load(&constraints.invInertiaRnA[i]), pseudoImpulse);
+    scatterSolverBodies(solverBodies, indicesB, &SolverBody::pseudoVelocity, &SolverBody::pseudoAngularVelocity,
+                        &SolverBody::pseudoInvMass, normal, Vector3x4::load(&constraints.invInertiaRnB[i]),
+                        _mm_sub_ps(_mm_setzero_ps(), pseudoImpulse));
+    return horizontalMaxAbs(pseudoImpulse);
+#else
+    float residual = 0.0f;
+    for (std::size_t k = i; k < i + PE_SolverSIMDWidth; ++k)
+        residual = std::max(residual, _solvePseudoImpulse(context, k));
+    return residual;
+#endif
 }
 
 } // namespace PE
@@ -6,6 +6,8 @@
 #include "../Bodies/Body.h"
 #include "ContactTypes.h"
 #include "ContactsContainer.h"
+#include "ContactConstraints.h"
+#include "ThreadPool.h"
 #include "../CollisionDetected/CollisionDetected.h"
 
 namespace PE {
@@ -15,11 +17,22 @@ class Solver:
 {
 public:
     Solver();
+    virtual ~Solver();
 
     void setCountIterations(int solverCountIterations, int splitImpulsesCountIterations);
     int solverCountIterations() const;
     int splitImpulsesIterations() const;
 
+    float residualTolerance() const;
+    void setResidualTolerance(float residualTolerance);
+
+    int countThreads() const;
+    void setCountThreads(int countThreads);
+
+    // Solves normal impulses of a whole manifold at once in islands solved on one thread.
+    bool enableBlockSolver() const;
+    void setEnableBlockSolver(bool enable);
+
     void preSolve(ContactManifold& cM, Body* bodyA, Body* bodyB);
     void preSolve_static(ContactManifold& cM, Body* bodyA);
     void solveImpulse(float e, Body* bodyA, Body* bodyB, const Vector3& normal, const R_ContactPoint& cPA, const R_ContactPoint& cPB, InfoPointOnCM& cInfo);
@@ -29,14 +42,51 @@ public:
     void solvePseudoImpulse(Body* bodyA, Body* bodyB, const Vector3& normal, const R_ContactPoint& cPA, const R_ContactPoint& cPB, InfoPointOnCM& cInfo);
     void solvePseudoImpulse_static(Body* bodyA, const Vector3& normal, const R_ContactPoint& cPA, InfoPointOnCM& cInfo);
 
-    void preSolve();
-    void solveContacts();
-    void solvePseudoContacts();
-    virtual void solve();
+    void preSolve(SolverContext& context, const Island& island);
+    float solveContacts(SolverContext& context);
+    float solvePseudoContacts(SolverContext& context);
+    void storeImpulses(SolverContext& context);
+    void storeSolverBodies(SolverContext& context);
+    void solve();
+    // Gives back the temporary memory of the thread contexts, called at the start of every update.
+    void resetScratchArenas();
+    virtual void solveIsland(SolverContext& context, Island& island);
+
+protected:
+    ThreadPool m_threadPool;
+    // Coloring keeps the Gauss-Seidel order of a large island solved by several threads.
+    bool m_enableColoring;
 
 private:
     int m_solverCountIterations;
     int m_splitImpulsesIterations;
+    float m_residualTolerance;
+    bool m_enableBlockSolver;
+
+    std::vector<SolverContext> m_contexts;
+    std::vector<std::size_t> m_islandOrder;
+    std::vector<std::size_t> m_islandTasks;
+    std::size_t m_countLargeIslands;
+
+    void _scheduleIslands();
+    void _colorConstraints(SolverContext& context, const Island& island);
+    void _solveColoredContacts(SolverContext& context, Island& island);
+    float _solveColors(SolverContext& context, ThreadBarrier& barrier, int pass,
+                       int threadIndex, int countThreads, bool pseudo);
+    float _solveColor(SolverContext& context, std::size_t color, int threadIndex, int countThreads, bool pseudo);
+
+    float _solveBlockContacts(SolverContext& context);
+    float _solveBlockImpulse(SolverContext& context, std::size_t k);
+
+    float _solveImpulse(SolverContext& context, std::size_t i);
+    float _solveImpulseFriction(SolverContext& context, std::size_t i);
+    float _solvePseudoImpulse(SolverContext& context, std::size_t i);
+    float _solveImpulseBatch(SolverContext& context, std::size_t i);
+    float _solveImpulseFrictionBatch(SolverContext& context, std::size_t i);
+    float _solvePseudoImpulseBatch(SolverContext& context, std::size_t i);
+
+    std::uint32_t _solverBodyIndex(SolverContext& context, Body* body);
+    std::size_t _constraintSlot(SolverContext& context, std::uint32_t indexA, std::uint32_t indexB);
 };
 
 } // namespace PE
@@ -0,0 +1,105 @@
+#include "ThreadPool.h"
+
+namespace PE {
+
+ThreadPool::ThreadPool()
+{
+    m_invoke = nullptr;
+    m_task = nullptr;
+    m_generation = 0;
+    m_countRunning = 0;
+    m_stop = false;
+}
+
+ThreadPool::~ThreadPool()
+{
+    _stopThreads();
+}
+
+int ThreadPool::countThreads() const
+{
+    return (int)m_threads.size() + 1;
+}
+
+void ThreadPool::setCountThreads(int countThreads)
+{
+    _stopThreads();
+    for (int i = 1; i < countThreads; ++i)
+        m_threads.push_back(std::thread(&ThreadPool::_work, this, i, m_generation));
+}
+
+void ThreadPool::_run(InvokeFunction invoke, const void* task)
+{
+    if (m_threads.empty()) {
+        invoke(task, 0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_invoke = invoke;
+        m_task = task;
+        m_countRunning = m_threads.size();
+        ++m_generation;
+    }
+    m_startCondition.notify_all();
+    invoke(task, 0);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finishCondition.wait(lock, [this] { return (m_countRunning == 0); });
+    m_invoke = nullptr;
+    m_task = nullptr;
+}
+
+void ThreadPool::_stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCondition.notify_all();
+    for (auto it = m_threads.begin(); it != m_threads.end(); ++it)
+        it->join();
+    m_threads.clear();
+    m_stop = false;
+}
+
+void ThreadPool::_work(int threadIndex, std::size_t generation)
+{
+    for (;;) {
+        InvokeFunction invoke;
+        const void* task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, generation] { return (m_stop || (m_generation != generation)); });
+            if (m_stop)
+                return;
+            generation = m_generation;
+            invoke = m_invoke;
+            task = m_task;
+        }
+        invoke(task, threadIndex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_countRunning;
+        }
+        m_finishCondition.notify_one();
+    }
+}
+
+ThreadBarrier::ThreadBarrier(int countThreads):
+    m_countThreads(countThreads), m_countWaiting(0), m_generation(0)
+{
+}
+
+void ThreadBarrier::wait()
+{
+    int generation = m_generation.load();
+    if (m_countWaiting.fetch_add(1) + 1 == m_countThreads) {
+        m_countWaiting.store(0);
+        m_generation.fetch_add(1);
+    } else {
+        while (m_generation.load() == generation)
+            std::this_thread::yield();
+    }
+}
+
+} // namespace PE
@@ -0,0 +1,76 @@
+#ifndef PE_THREADPOOL_H
+#define PE_THREADPOOL_H
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace PE {
+
+class ThreadPool
+{
+public:
+    ThreadPool();
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    int countThreads() const;
+    void setCountThreads(int countThreads);
+
+    // Calls task(threadIndex) once on every thread, the calling thread is 0, and waits for all of them.
+    // The task is passed by reference, so running it does not allocate.
+    template <typename Task>
+    void run(const Task& task);
+
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_finishCondition;
+    typedef void (*InvokeFunction)(const void* task, int threadIndex);
+
+    InvokeFunction m_invoke;
+    const void* m_task;
+    std::size_t m_generation;
+    std::size_t m_countRunning;
+    bool m_stop;
+
+    template <typename Task>
+    static void _invoke(const void* task, int threadIndex);
+    void _run(InvokeFunction invoke, const void* task);
+    void _stopThreads();
+    void _work(int threadIndex, std::size_t generation);
+};
+
+class ThreadBarrier
+{
+public:
+    ThreadBarrier(int countThreads);
+
+    void wait();
+
+private:
+    int m_countThreads;
+    std::atomic<int> m_countWaiting;
+    std::atomic<int> m_generation;
+};
+
+template <typename Task>
+void ThreadPool::run(const Task& task)
+{
+    _run(&ThreadPool::_invoke<Task>, &task);
+}
+
+template <typename Task>
+void ThreadPool::_invoke(const void* task, int threadIndex)
+{
+    (*static_cast<const Task*>(task))(threadIndex);
+}
+
+} // namespace PE
+
+#endif // PE_THREADPOOL_H
@@ -0,0 +1,70 @@
+#include "Allocator.h"
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include "../Settings.h"
+
+namespace PE {
+
+namespace {
+
+std::atomic<std::size_t> g_countHeapAllocations(0);
+
+class HeapAllocator:
+        public Allocator
+{
+public:
+    void* allocate(std::size_t size) override
+    {
+        return ::operator new(size);
+    }
+
+    void deallocate(void* pointer, std::size_t size) override
+    {
+        (void)size;
+        ::operator delete(pointer);
+    }
+};
+
+} // namespace
+
+Allocator::~Allocator()
+{
+}
+
+Allocator* Allocator::defaultAllocator()
+{
+    static HeapAllocator allocator;
+    return &allocator;
+}
+
+std::size_t Allocator::countHeapAllocations()
+{
+    return g_countHeapAllocations.load(std::memory_order_relaxed);
+}
+
+} // namespace PE
+
+#if PE_CountHeapAllocations
+
+void* operator new(std::size_t size)
+{
+    PE::g_countHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* pointer = std::malloc((size > 0) ? size : 1);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t size) noexcept
+{
+    (void)size;
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef PE_ALLOCATOR_H
+#define PE_ALLOCATOR_H
+
+#include <cstddef>
+
+namespace PE {
+
+// Memory of the physics world pools comes from here, a custom allocator has to outlive the world.
+class Allocator
+{
+public:
+    virtual ~Allocator();
+
+    virtual void* allocate(std::size_t size) = 0;
+    virtual void deallocate(void* pointer, std::size_t size) = 0;
+
+    static Allocator* defaultAllocator();
+    // Calls of the global operator new so far, always 0 unless PE_CountHeapAllocations is enabled.
+    static std::size_t countHeapAllocations();
+};
+
+} // namespace PE
+
+#endif // PE_ALLOCATOR_H
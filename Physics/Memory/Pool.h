@@ -0,0 +1,104 @@
+#ifndef PE_POOL_H
+#define PE_POOL_H
+
+#include <new>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include "../Settings.h"
+#include "Allocator.h"
+
+namespace PE {
+
+// Objects are constructed in blocks of the same type, destroyed objects give their slot to the next one.
+// Blocks are returned to the allocator only with the pool, objects still alive at that moment are not destroyed.
+template <typename Type>
+class Pool
+{
+public:
+    Pool(Allocator* allocator, std::size_t countObjectsInBlock = PE_PoolBlockSize);
+    ~Pool();
+
+    Pool(const Pool&) = delete;
+    Pool& operator = (const Pool&) = delete;
+
+    template <typename... Args>
+    Type* create(Args&&... args);
+    void destroy(Type* object);
+
+    std::size_t countObjects() const;
+
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+    };
+
+    Allocator* m_allocator;
+    std::size_t m_countObjectsInBlock;
+    std::vector<Slot*> m_blocks;
+    Slot* m_freeSlots;
+    std::size_t m_countObjects;
+
+    void _addBlock();
+};
+
+template <typename Type>
+Pool<Type>::Pool(Allocator* allocator, std::size_t countObjectsInBlock)
+{
+    m_allocator = allocator;
+    m_countObjectsInBlock = countObjectsInBlock;
+    m_freeSlots = nullptr;
+    m_countObjects = 0;
+}
+
+template <typename Type>
+Pool<Type>::~Pool()
+{
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+        m_allocator->deallocate(*it, sizeof(Slot) * m_countObjectsInBlock);
+}
+
+template <typename Type>
+template <typename... Args>
+Type* Pool<Type>::create(Args&&... args)
+{
+    if (m_freeSlots == nullptr)
+        _addBlock();
+    Slot* slot = m_freeSlots;
+    m_freeSlots = slot->next;
+    ++m_countObjects;
+    return new (&slot->storage) Type(std::forward<Args>(args)...);
+}
+
+template <typename Type>
+void Pool<Type>::destroy(Type* object)
+{
+    object->~Type();
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    slot->next = m_freeSlots;
+    m_freeSlots = slot;
+    --m_countObjects;
+}
+
+template <typename Type>
+std::size_t Pool<Type>::countObjects() const
+{
+    return m_countObjects;
+}
+
+template <typename Type>
+void Pool<Type>::_addBlock()
+{
+    Slot* block = static_cast<Slot*>(m_allocator->allocate(sizeof(Slot) * m_countObjectsInBlock));
+    for (std::size_t i = 0; i + 1 < m_countObjectsInBlock; ++i)
+        block[i].next = &block[i + 1];
+    block[m_countObjectsInBlock - 1].next = m_freeSlots;
+    m_freeSlots = block;
+    m_blocks.push_back(block);
+}
+
+} // namespace PE
+
+#endif // PE_POOL_H
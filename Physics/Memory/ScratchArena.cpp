@@ -0,0 +1,111 @@
+#include "ScratchArena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace PE {
+
+ScratchArena::ScratchArena(Allocator* allocator, std::size_t blockSize)
+{
+    m_allocator = (allocator != nullptr) ? allocator : Allocator::defaultAllocator();
+    m_blockSize = blockSize;
+    m_indexBlock = 0;
+    m_offset = 0;
+    m_countBlockAllocations = 0;
+}
+
+ScratchArena::ScratchArena(ScratchArena&& arena) noexcept:
+    m_allocator(arena.m_allocator),
+    m_blockSize(arena.m_blockSize),
+    m_blocks(std::move(arena.m_blocks)),
+    m_indexBlock(arena.m_indexBlock),
+    m_offset(arena.m_offset),
+    m_countBlockAllocations(arena.m_countBlockAllocations)
+{
+    arena.m_blocks.clear();
+    arena.m_indexBlock = 0;
+    arena.m_offset = 0;
+}
+
+ScratchArena::~ScratchArena()
+{
+    _freeBlocks();
+}
+
+void* ScratchArena::allocate(std::size_t size, std::size_t alignment)
+{
+    for (;;) {
+        if (m_indexBlock < m_blocks.size()) {
+            const Block& block = m_blocks[m_indexBlock];
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.data) + m_offset;
+            std::size_t offset = m_offset + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+            if (offset + size <= block.size) {
+                m_offset = offset + size;
+                return block.data + offset;
+            }
+            if (m_indexBlock + 1 < m_blocks.size()) {
+                ++m_indexBlock;
+                m_offset = 0;
+                continue;
+            }
+        }
+        _addBlock(std::max(m_blockSize, size + alignment));
+    }
+}
+
+ScratchArena::Marker ScratchArena::marker() const
+{
+    Marker marker;
+    marker.block = m_indexBlock;
+    marker.offset = m_offset;
+    return marker;
+}
+
+void ScratchArena::rewind(const Marker& marker)
+{
+    m_indexBlock = marker.block;
+    m_offset = marker.offset;
+}
+
+void ScratchArena::reset()
+{
+    if (m_blocks.size() > 1) {
+        std::size_t size = 0;
+        for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+            size += it->size;
+        _freeBlocks();
+        _addBlock(size);
+    }
+    m_indexBlock = 0;
+    m_offset = 0;
+}
+
+std::size_t ScratchArena::countBlockAllocations() const
+{
+    return m_countBlockAllocations;
+}
+
+ScratchArena& ScratchArena::local()
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+void ScratchArena::_addBlock(std::size_t size)
+{
+    Block block;
+    block.data = static_cast<char*>(m_allocator->allocate(size));
+    block.size = size;
+    m_blocks.push_back(block);
+    m_indexBlock = m_blocks.size() - 1;
+    m_offset = 0;
+    ++m_countBlockAllocations;
+}
+
+void ScratchArena::_freeBlocks()
+{
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+        m_allocator->deallocate(it->data, it->size);
+    m_blocks.clear();
+}
+
+} // namespace PE
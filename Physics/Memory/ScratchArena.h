@@ -0,0 +1,96 @@
+#ifndef PE_SCRATCHARENA_H
+#define PE_SCRATCHARENA_H
+
+#include <new>
+#include <vector>
+#include <cstddef>
+#include "../Settings.h"
+#include "Allocator.h"
+
+namespace PE {
+
+// Linear memory for temporary buffers. Allocation moves a pointer, memory is given back all at once with
+// rewind or reset and the blocks are kept for the next use. Only types without destructors belong here.
+class ScratchArena
+{
+public:
+    struct Marker
+    {
+        std::size_t block;
+        std::size_t offset;
+    };
+
+    ScratchArena(Allocator* allocator = nullptr, std::size_t blockSize = PE_ScratchArenaBlockSize);
+    ScratchArena(ScratchArena&& arena) noexcept;
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator = (const ScratchArena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+    template <typename Type>
+    Type* allocate(std::size_t count);
+
+    Marker marker() const;
+    void rewind(const Marker& marker);
+    // Gives back everything, blocks of a step that did not fit into one block are merged into one.
+    void reset();
+
+    std::size_t countBlockAllocations() const;
+
+    // Arena of the calling thread for code that runs outside of a physics world.
+    static ScratchArena& local();
+
+private:
+    struct Block
+    {
+        char* data;
+        std::size_t size;
+    };
+
+    Allocator* m_allocator;
+    std::size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    std::size_t m_indexBlock;
+    std::size_t m_offset;
+    std::size_t m_countBlockAllocations;
+
+    void _addBlock(std::size_t size);
+    void _freeBlocks();
+};
+
+// Rewinds the arena to where it was when the scope was entered.
+class ScratchScope
+{
+public:
+    ScratchScope(ScratchArena& arena):
+        m_arena(arena),
+        m_marker(arena.marker())
+    {
+    }
+
+    ~ScratchScope()
+    {
+        m_arena.rewind(m_marker);
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator = (const ScratchScope&) = delete;
+
+private:
+    ScratchArena& m_arena;
+    ScratchArena::Marker m_marker;
+};
+
+template <typename Type>
+Type* ScratchArena::allocate(std::size_t count)
+{
+    Type* objects = static_cast<Type*>(allocate(sizeof(Type) * count, alignof(Type)));
+    for (std::size_t i = 0; i < count; ++i)
+        new (objects + i) Type;
+    return objects;
+}
+
+} // namespace PE
+
+#endif // PE_SCRATCHARENA_H
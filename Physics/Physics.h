@@ -5,9 +5,12 @@
 #include "VectorMath/Vector2.h"
 #include "VectorMath/Vector3.h"
 #include "VectorMath/RotationMatrix.h"
+#include "VectorMath/Quaternion.h"
+#include "VectorMath/Matrix3.h"
 #include "Bodies/Body.h"
 #include "Bodies/BoundsTrees.h"
 #include "Bodies/Capsule.h"
+#include "Bodies/ConvexGeometry.h"
 #include "Bodies/Hull.h"
 #include "Bodies/Material.h"
 #include "Bodies/QuickHull.h"
@@ -2,26 +2,131 @@
 #include <cmath>
 #include <cassert>
 #include <memory>
-#include "Bodies/Sphere.h"
-#include "Bodies/Capsule.h"
-#include "Bodies/Hull.h"
+#include <chrono>
+#include <algorithm>
+#include <limits>
 
 namespace PE {
 
-PhysicsWorld::PhysicsWorld(const Vector3& gravity)
+PhysicsWorld::PhysicsWorld(const Vector3& gravity, Allocator* allocator):
+    m_allocator((allocator != nullptr) ? allocator : Allocator::defaultAllocator()),
+    m_bodyPool(m_allocator),
+    m_spherePool(m_allocator),
+    m_capsulePool(m_allocator),
+    m_hullPool(m_allocator),
+    m_scratchArena(m_allocator)
 {
     m_gravity = gravity;
     m_damp = 0.99f;
     m_sleepTime = 60;
     m_sleepVelocity = 0.1f;
     m_sleepAngularVelocity = 0.1f;
-    m_countIterationsForCollisionGroups = 150;
+    m_solverType = SolverType::ShockPropagation;
+    m_solver = std::unique_ptr<Solver>(new ShockPropagationSolver());
+    m_enableShockPropagation = true;
+    m_countSubsteps = 1;
+    m_report = UpdateReport{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0, false, false, false, 0 };
+    m_solverPassCost = 0.0f;
 }
 
 PhysicsWorld::~PhysicsWorld()
 {
     while (!m_bodies.empty())
-        delete m_bodies[m_bodies.size() - 1];
+        destroyBody(m_bodies[m_bodies.size() - 1]);
+}
+
+Body* PhysicsWorld::createBody()
+{
+    Body* body = m_bodyPool.create(this);
+    body->m_isPooled = true;
+    return body;
+}
+
+Sphere* PhysicsWorld::createSphere(const Vector3& localPosition, float radius)
+{
+    Sphere* sphere = m_spherePool.create(localPosition, radius);
+    sphere->m_pool = this;
+    return sphere;
+}
+
+Capsule* PhysicsWorld::createCapsule(float length, float radius)
+{
+    Capsule* capsule = m_capsulePool.create(length, radius);
+    capsule->m_pool = this;
+    return capsule;
+}
+
+Capsule* PhysicsWorld::createCapsule(const Vector3& vertexA, const Vector3& vertexB, float radius)
+{
+    Capsule* capsule = m_capsulePool.create(vertexA, vertexB, radius);
+    capsule->m_pool = this;
+    return capsule;
+}
+
+Hull* PhysicsWorld::createHull()
+{
+    Hull* hull = m_hullPool.create();
+    hull->m_pool = this;
+    return hull;
+}
+
+Hull* PhysicsWorld::createHull(const std::shared_ptr<const ConvexGeometry>& geometry)
+{
+    Hull* hull = m_hullPool.create(geometry);
+    hull->m_pool = this;
+    return hull;
+}
+
+Shape* PhysicsWorld::createCopy(const Shape* shape)
+{
+    Shape* copy = nullptr;
+    switch (shape->type()) {
+    case TypeShape::Sphere:
+        copy = m_spherePool.create(*static_cast<const Sphere*>(shape));
+        break;
+    case TypeShape::Capsule:
+        copy = m_capsulePool.create(*static_cast<const Capsule*>(shape));
+        break;
+    case TypeShape::Hull:
+        copy = m_hullPool.create(*static_cast<const Hull*>(shape));
+        break;
+    default:
+        return shape->copy();
+    }
+    copy->m_body = nullptr;
+    copy->m_index = std::numeric_limits<std::size_t>::max();
+    copy->m_pool = this;
+    return copy;
+}
+
+void PhysicsWorld::destroyBody(Body* body)
+{
+    if (body->m_isPooled)
+        body->m_physicsWorld->m_bodyPool.destroy(body);
+    else
+        delete body;
+}
+
+void PhysicsWorld::destroyShape(Shape* shape)
+{
+    PhysicsWorld* pool = shape->m_pool;
+    if (pool == nullptr) {
+        delete shape;
+        return;
+    }
+    switch (shape->type()) {
+    case TypeShape::Sphere:
+        pool->m_spherePool.destroy(static_cast<Sphere*>(shape));
+        break;
+    case TypeShape::Capsule:
+        pool->m_capsulePool.destroy(static_cast<Capsule*>(shape));
+        break;
+    case TypeShape::Hull:
+        pool->m_hullPool.destroy(static_cast<Hull*>(shape));
+        break;
+    default:
+        break;
+    }
 }
 
 float PhysicsWorld::damp() const
@@ -34,39 +139,99 @@ void PhysicsWorld::setDamp(float damp)
     m_damp = damp;
 }
 
-int PhysicsWorld::countIterationsForCollisionGroups() const
+SolverType PhysicsWorld::solverType() const
 {
-    return m_countIterationsForCollisionGroups;
+    return m_solverType;
 }
 
-void PhysicsWorld::setCountIterationsForCollisionGroups(int countIterationsForCollisionGroup)
+void PhysicsWorld::setSolverType(SolverType solverType)
 {
-    m_countIterationsForCollisionGroups = countIterationsForCollisionGroup;
+    if (m_solverType == solverType)
+        return;
+    std::unique_ptr<Solver> solver;
+    switch (solverType) {
+    case SolverType::ShockPropagation: {
+        ShockPropagationSolver* shockPropagationSolver = new ShockPropagationSolver();
+        shockPropagationSolver->setEnableShockPropagation(m_enableShockPropagation);
+        solver = std::unique_ptr<Solver>(shockPropagationSolver);
+    } break;
+    case SolverType::Jacobi:
+        solver = std::unique_ptr<Solver>(new JacobiSolver());
+        break;
+    }
+    solver->setCountIterations(m_solver->solverCountIterations(), m_solver->splitImpulsesIterations());
+    solver->setResidualTolerance(m_solver->residualTolerance());
+    solver->setCountThreads(m_solver->countThreads());
+    solver->separationCache().setEnabled(m_solver->separationCache().isEnabled());
+    solver->setEnableBlockSolver(m_solver->enableBlockSolver());
+    m_solver = std::move(solver);
+    m_solverType = solverType;
 }
 
 bool PhysicsWorld::enableShockPropagation() const
 {
-    return m_solver.enableShockPropagation();
+    return m_enableShockPropagation;
 }
 
 void PhysicsWorld::setEnableShockPropagation(bool enable)
 {
-    m_solver.setEnableShockPropagation(enable);
+    m_enableShockPropagation = enable;
+    _setSolverShockPropagation(enable);
+}
+
+bool PhysicsWorld::enableSeparationCache() const
+{
+    return m_solver->separationCache().isEnabled();
+}
+
+void PhysicsWorld::setEnableSeparationCache(bool enable)
+{
+    m_solver->separationCache().setEnabled(enable);
+}
+
+bool PhysicsWorld::enableBlockSolver() const
+{
+    return m_solver->enableBlockSolver();
+}
+
+void PhysicsWorld::setEnableBlockSolver(bool enable)
+{
+    m_solver->setEnableBlockSolver(enable);
 }
 
 void PhysicsWorld::setCountIterations(int solverCountIterations, int splitImpulsesCountIterations)
 {
-    m_solver.setCountIterations(solverCountIterations, splitImpulsesCountIterations);
+    m_solver->setCountIterations(solverCountIterations, splitImpulsesCountIterations);
 }
 
 int PhysicsWorld::solverCountIterations() const
 {
-    return m_solver.solverCountIterations();
+    return m_solver->solverCountIterations();
 }
 
 int PhysicsWorld::splitImpulsesIterations() const
 {
-    return m_solver.splitImpulsesIterations();
+    return m_solver->splitImpulsesIterations();
+}
+
+float PhysicsWorld::solverResidualTolerance() const
+{
+    return m_solver->residualTolerance();
+}
+
+void PhysicsWorld::setSolverResidualTolerance(float residualTolerance)
+{
+    m_solver->setResidualTolerance(residualTolerance);
+}
+
+int PhysicsWorld::countThreads() const
+{
+    return m_solver->countThreads();
+}
+
+void PhysicsWorld::setCountThreads(int countThreads)
+{
+    m_solver->setCountThreads(countThreads);
 }
 
 float PhysicsWorld::sleepVelocity() const
@@ -91,93 +256,441 @@ void PhysicsWorld::setSleepAngularVelocity(float sleepAngularVelocity)
 
 const ContactsContainer& PhysicsWorld::contactsContainer() const
 {
-    return m_solver;
+    return *m_solver;
+}
+
+std::size_t PhysicsWorld::countBodies() const
+{
+    return m_bodies.size();
+}
+
+Body* PhysicsWorld::body(std::size_t index) const
+{
+    return m_bodies[index];
+}
+
+const CollisionGroup& PhysicsWorld::collisionGroup(std::uint32_t id) const
+{
+    return m_collisionGroups[id];
+}
+
+Body* PhysicsWorld::body(BodyHandle handle) const
+{
+    if (handle.slot >= m_bodySlots.size())
+        return nullptr;
+    const BodySlot& slot = m_bodySlots[handle.slot];
+    return (slot.generation == handle.generation) ? slot.body : nullptr;
+}
+
+int PhysicsWorld::countSubsteps() const
+{
+    return m_countSubsteps;
+}
+
+void PhysicsWorld::setCountSubsteps(int countSubsteps)
+{
+    m_countSubsteps = std::max(countSubsteps, 1);
 }
 
-void PhysicsWorld::update(float dt)
+void PhysicsWorld::update(float dt, float budget)
 {
+    typedef std::chrono::steady_clock Clock;
+    auto seconds = [] (Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<float>(b - a).count();
+    };
     assert(dt > PE_EPSf);
-    _updateBodies(dt);
+    int solverCountIterations = m_solver->solverCountIterations();
+    int splitImpulsesIterations = m_solver->splitImpulsesIterations();
+    Clock::time_point start = Clock::now();
+    std::size_t countHeapAllocations = Allocator::countHeapAllocations();
+    m_scratchArena.reset();
+    m_solver->resetScratchArenas();
+    m_report.budget = budget;
+    m_report.solverCountIterations = solverCountIterations;
+    m_report.splitImpulsesIterations = splitImpulsesIterations;
+    m_report.shockPropagation = m_enableShockPropagation && (m_solverType == SolverType::ShockPropagation);
+    m_report.degraded = false;
+    m_report.overBudget = false;
+    dt /= m_countSubsteps;
+    float damping = (m_countSubsteps > 1) ? std::pow(m_damp, 1.0f / m_countSubsteps) : m_damp;
+    _updateBodies(dt, damping);
+    Clock::time_point bodiesEnd = Clock::now();
+    m_report.timeBodies = seconds(start, bodiesEnd);
     _updateCollisions(1.0f / dt);
-    m_solver.solve();
-    for (int i = 0; i < m_countIterationsForCollisionGroups; ++i)
-        m_solver.updateCollisionGroups();
+    Clock::time_point collisionsEnd = Clock::now();
+    m_report.timeCollisions = seconds(bodiesEnd, collisionsEnd);
+    m_solver->buildIslands();
+    Clock::time_point islandsEnd = Clock::now();
+    m_report.timeIslands = seconds(collisionsEnd, islandsEnd);
+    if (budget > 0.0f)
+        _degradeSolver(budget - seconds(start, islandsEnd), m_countSubsteps);
+    Clock::time_point solverStart = Clock::now();
+    m_solver->solve();
+    m_report.timeSolver = seconds(solverStart, Clock::now());
+    // The pass cost is taken from the solves alone and the iterations the islands really ran, early exits included.
+    std::size_t countPasses = _countSolverPasses();
+    for (int i = 1; i < m_countSubsteps; ++i) {
+        if (budget > 0.0f) {
+            if (countPasses > 0)
+                m_solverPassCost = m_report.timeSolver / countPasses;
+            _degradeSolver(budget - seconds(start, Clock::now()), m_countSubsteps - i);
+        }
+        Clock::time_point substepStart = Clock::now();
+        _integrateBodies(dt, damping);
+        Clock::time_point substepBodiesEnd = Clock::now();
+        m_report.timeBodies += seconds(substepStart, substepBodiesEnd);
+        m_solver->refreshContacts(1.0f / dt);
+        solverStart = Clock::now();
+        m_report.timeCollisions += seconds(substepBodiesEnd, solverStart);
+        m_solver->solve();
+        m_report.timeSolver += seconds(solverStart, Clock::now());
+        countPasses += _countSolverPasses();
+    }
+    if (countPasses > 0)
+        m_solverPassCost = m_report.timeSolver / countPasses;
+    _updateSleeping();
+    Clock::time_point end = Clock::now();
+    m_report.time = seconds(start, end);
+    m_report.overBudget = (budget > 0.0f) && (m_report.time > budget);
+    m_report.countHeapAllocations = Allocator::countHeapAllocations() - countHeapAllocations;
+    if (m_report.degraded) {
+        m_solver->setCountIterations(solverCountIterations, splitImpulsesIterations);
+        _setSolverShockPropagation(m_enableShockPropagation);
+    }
+}
+
+const UpdateReport& PhysicsWorld::lastUpdateReport() const
+{
+    return m_report;
+}
+
+void PhysicsWorld::_degradeSolver(float time, int countSolves)
+{
+    if ((m_solverPassCost <= 0.0f) || (m_solver->countContactManifolds() == 0))
+        return;
+    float countPasses = std::max(time, 0.0f) /
+            (m_solverPassCost * m_solver->countContactManifolds() * countSolves);
+    int& solverCountIterations = m_report.solverCountIterations;
+    int& splitImpulsesIterations = m_report.splitImpulsesIterations;
+    if (countPasses >= solverCountIterations + splitImpulsesIterations + (m_report.shockPropagation ? 1 : 0))
+        return;
+    m_report.degraded = true;
+    if (m_report.shockPropagation) {
+        m_report.shockPropagation = false;
+        _setSolverShockPropagation(false);
+    }
+    if (countPasses < solverCountIterations + splitImpulsesIterations)
+        splitImpulsesIterations = std::max(1, (int)countPasses - solverCountIterations);
+    if (countPasses < solverCountIterations + splitImpulsesIterations)
+        solverCountIterations = std::max(1, (int)countPasses - splitImpulsesIterations);
+    m_solver->setCountIterations(solverCountIterations, splitImpulsesIterations);
+}
+
+std::size_t PhysicsWorld::_countSolverPasses() const
+{
+    std::size_t countPasses = 0;
+    for (std::size_t i = 0; i < m_solver->countIslands(); ++i) {
+        const ContactsContainer::Island& island = m_solver->island(i);
+        countPasses += island.countManifolds * (island.countIterations + island.countSplitImpulsesIterations +
+                                                (m_report.shockPropagation ? 1 : 0));
+    }
+    return countPasses;
 }
 
-std::size_t PhysicsWorld::_addBody(Body* body)
+void PhysicsWorld::_setSolverShockPropagation(bool enable)
 {
+    if (m_solverType == SolverType::ShockPropagation)
+        static_cast<ShockPropagationSolver*>(m_solver.get())->setEnableShockPropagation(enable);
+}
+
+void PhysicsWorld::_addBody(Body* body)
+{
+    if (m_freeBodySlots.empty()) {
+        body->m_handle.slot = (std::uint32_t)m_bodySlots.size();
+        m_bodySlots.push_back(BodySlot{ body, 1 });
+        m_collisionGroups.push_back(CollisionGroup());
+    } else {
+        body->m_handle.slot = m_freeBodySlots[m_freeBodySlots.size() - 1];
+        m_freeBodySlots.pop_back();
+        m_bodySlots[body->m_handle.slot].body = body;
+    }
+    body->m_handle.generation = m_bodySlots[body->m_handle.slot].generation;
+    m_collisionGroups[body->m_handle.slot] = CollisionGroup();
+    body->m_defaultCollisionGroup = body->m_currentCollisionGroup = body->m_handle.slot;
+    body->m_awakeIndex = m_awakeBodies.size();
+    m_awakeBodies.push_back(body);
+    body->m_index = m_bodies.size();
     m_bodies.push_back(body);
-    return m_bodies.size() - 1;
 }
 
-void PhysicsWorld::_removeBody(std::size_t index)
+void PhysicsWorld::_removeBody(Body* body)
 {
-    m_bodies.erase(m_bodies.begin() + index);
+    if (_collisionGroup(body).nonSleep) {
+        _removeAwakeBody(body);
+    } else {
+        Body* prev = body;
+        while (prev->m_nextSleeping != body)
+            prev = prev->m_nextSleeping;
+        prev->m_nextSleeping = body->m_nextSleeping;
+        if (prev != body)
+            _wakeUp(prev);
+        else
+            _removeSleepingIsland(body->m_sleepingIsland);
+    }
+    Body* last = m_bodies[m_bodies.size() - 1];
+    last->m_index = body->m_index;
+    m_bodies[body->m_index] = last;
+    m_bodies.pop_back();
+    BodySlot& slot = m_bodySlots[body->m_handle.slot];
+    slot.body = nullptr;
+    ++slot.generation;
+    m_freeBodySlots.push_back(body->m_handle.slot);
 }
 
-void PhysicsWorld::_updateBodies(float dt)
+void PhysicsWorld::_removeShape(const Shape* shape)
 {
+    m_solver->separationCache().removeShape(shape);
+    m_solver->removeShape(shape);
+}
 
-    for (auto it = m_bodies.begin(); it != m_bodies.end(); ++it) {
-        Body* body = *it;
-        if (body->isEnabled()) {
-            if (body->isDynamic()) {
-                if (body->isEnabled() && body->m_defaultCollisionGroup->nonSleep) {
-                    if ((body->velocity().inBound(m_sleepVelocity)) &&
-                        (body->angularVelocity().inBound(m_sleepAngularVelocity))) {
-                        ++body->m_defaultCollisionGroup->time_without_movement;
-                        if (body->m_currentCollisionGroup->time_without_movement >
-                                body->m_defaultCollisionGroup->time_without_movement) {
-                            body->m_currentCollisionGroup->time_without_movement =
-                                    body->m_defaultCollisionGroup->time_without_movement;
-                        } else {
-                            body->m_defaultCollisionGroup->time_without_movement =
-                                    body->m_currentCollisionGroup->time_without_movement;
-                        }
-                    } else {
-                        body->m_defaultCollisionGroup->time_without_movement = 0;
-                        body->m_currentCollisionGroup->time_without_movement = 0;
-                    }
+CollisionGroup& PhysicsWorld::_collisionGroup(const Body* body)
+{
+    return m_collisionGroups[body->m_defaultCollisionGroup];
+}
+
+void PhysicsWorld::_removeAwakeBody(Body* body)
+{
+    Body* last = m_awakeBodies[m_awakeBodies.size() - 1];
+    last->m_awakeIndex = body->m_awakeIndex;
+    m_awakeBodies[body->m_awakeIndex] = last;
+    m_awakeBodies.pop_back();
+}
+
+void PhysicsWorld::_wakeUp(Body* body)
+{
+    _removeSleepingIsland(body->m_sleepingIsland);
+    Body* next = body;
+    do {
+        Body* current = next;
+        next = current->m_nextSleeping;
+        current->m_nextSleeping = nullptr;
+        current->m_currentCollisionGroup = current->m_defaultCollisionGroup;
+        CollisionGroup& group = _collisionGroup(current);
+        group.nonSleep = true;
+        group.time_without_movement = 0;
+        current->m_awakeIndex = m_awakeBodies.size();
+        m_awakeBodies.push_back(current);
+    } while (next != body);
+}
+
+void PhysicsWorld::_sleep(Body* body, Body* nextSleeping)
+{
+    body->m_nextSleeping = nextSleeping;
+    _collisionGroup(body).nonSleep = false;
+    body->m_contacts.resize(0);
+    _removeAwakeBody(body);
+}
+
+void PhysicsWorld::_addSleepingIsland(Body* body)
+{
+    SleepingIsland island;
+    island.bounds.init();
+    island.body = body;
+    Body* current = body;
+    do {
+        current->m_sleepingIsland = m_sleepingIslands.size();
+        if (!current->boundsTree().isEmpty())
+            island.bounds.merge(current->boundsTree().rootNode().bounds);
+        current = current->m_nextSleeping;
+    } while (current != body);
+    m_sleepingIslands.push_back(island);
+}
+
+void PhysicsWorld::_removeSleepingIsland(std::size_t index)
+{
+    std::size_t lastIndex = m_sleepingIslands.size() - 1;
+    if (index != lastIndex) {
+        m_sleepingIslands[index] = m_sleepingIslands[lastIndex];
+        Body* body = m_sleepingIslands[index].body;
+        Body* current = body;
+        do {
+            current->m_sleepingIsland = index;
+            current = current->m_nextSleeping;
+        } while (current != body);
+    }
+    m_sleepingIslands.pop_back();
+}
+
+void PhysicsWorld::_mergeSleepingBounds(const Body* body)
+{
+    // A sleeping body moved by hand only grows the bounds of its island, they are exact again after it wakes up.
+    if (_collisionGroup(body).nonSleep || body->boundsTree().isEmpty())
+        return;
+    m_sleepingIslands[body->m_sleepingIsland].bounds.merge(body->boundsTree().rootNode().bounds);
+}
+
+void PhysicsWorld::_wakeUpSleepingIslands(const Bounds& bounds)
+{
+    std::size_t k = 0;
+    while (k < m_sleepingIslands.size()) {
+        bool overlap = false;
+        Body* body = m_sleepingIslands[k].body;
+        if (m_sleepingIslands[k].bounds.collision(bounds)) {
+            Body* current = body;
+            do {
+                if (current->isEnabled() && !current->boundsTree().isEmpty() &&
+                        current->boundsTree().rootNode().bounds.collision(bounds)) {
+                    overlap = true;
+                    break;
                 }
-            } else {
-                body->_updateContactsOnBody();
-            }
+                current = current->m_nextSleeping;
+            } while (current != body);
         }
+        if (overlap)
+            _wakeUp(body);
+        else
+            ++k;
     }
-    for (auto it = m_bodies.begin(); it != m_bodies.end(); ++it) {
+}
+
+void PhysicsWorld::_updateBodies(float dt, float damping)
+{
+    for (auto it = m_awakeBodies.begin(); it != m_awakeBodies.end(); ++it) {
         Body* body = *it;
-        if (body->isEnabled() && body->isDynamic()) {
-            body->m_defaultCollisionGroup->time_without_movement =
-                    body->m_currentCollisionGroup->time_without_movement;
-            if (body->m_defaultCollisionGroup->time_without_movement < m_sleepTime) {
-                body->m_defaultCollisionGroup->nonSleep = true;
-                body->update(dt, m_gravity, m_damp);
-                body->updateShapes();
-                body->updateBoundsTree();
-            } else {
-                body->m_currentCollisionGroup = body->m_defaultCollisionGroup;
-                body->m_defaultCollisionGroup->nonSleep = false;
-            }
+        if (!body->isEnabled())
+            continue;
+        body->_updateContactsOnBody();
+        if (body->isDynamic()) {
+            body->m_currentCollisionGroup = body->m_defaultCollisionGroup;
+            body->update(dt, m_gravity, damping);
+            body->updateShapes();
+            body->updateBoundsTree();
+        }
+    }
+}
+
+void PhysicsWorld::_integrateBodies(float dt, float damping)
+{
+    for (auto it = m_awakeBodies.begin(); it != m_awakeBodies.end(); ++it) {
+        Body* body = *it;
+        if (body->isEnabled() && body->isDynamic())
+            body->update(dt, m_gravity, damping);
+    }
+}
+
+void PhysicsWorld::_updateSleeping()
+{
+    std::size_t i, j;
+    for (auto it = m_awakeBodies.begin(); it != m_awakeBodies.end(); ++it) {
+        Body* body = *it;
+        if (!body->isEnabled() || !body->isDynamic())
+            continue;
+        CollisionGroup& group = m_collisionGroups[body->m_defaultCollisionGroup];
+        if ((body->velocity().inBound(m_sleepVelocity)) &&
+            (body->angularVelocity().inBound(m_sleepAngularVelocity))) {
+            ++group.time_without_movement;
+        } else {
+            group.time_without_movement = 0;
+        }
+    }
+    // An island falls asleep as a whole, its bodies are linked into a ring to be woken up together.
+    // The bodies keep the time of the island, so a body losing its contacts for a step does not fall asleep alone.
+    for (i = 0; i < m_solver->countIslands(); ++i) {
+        const ContactsContainer::Island& island = m_solver->island(i);
+        int time = _collisionGroup(m_solver->islandBody(island, 0)).time_without_movement;
+        for (j = 1; j < island.countBodies; ++j)
+            time = std::min(time, _collisionGroup(m_solver->islandBody(island, j)).time_without_movement);
+        if (time < m_sleepTime) {
+            for (j = 0; j < island.countBodies; ++j)
+                _collisionGroup(m_solver->islandBody(island, j)).time_without_movement = time;
+            continue;
+        }
+        for (j = 0; j < island.countBodies; ++j)
+            _sleep(m_solver->islandBody(island, j), m_solver->islandBody(island, (j + 1) % island.countBodies));
+        _addSleepingIsland(m_solver->islandBody(island, 0));
+    }
+    for (i = m_awakeBodies.size(); i > 0; --i) {
+        Body* body = m_awakeBodies[i - 1];
+        if (body->isEnabled() && body->isDynamic() && body->m_contacts.empty() &&
+                (_collisionGroup(body).time_without_movement >= m_sleepTime)) {
+            _sleep(body, body);
+            _addSleepingIsland(body);
         }
     }
 }
 
 void PhysicsWorld::_updateCollisions(float xdt)
 {
-    m_solver.deleteAllContacts();
-    for (auto itA = m_bodies.begin(); itA != m_bodies.end(); ++itA) {
-        Body* bodyA = *itA;
-        if (!bodyA->isEnabled())
+    m_solver->deleteAllContacts();
+    m_solver->separationCache().nextStep();
+    // Pairs of awake bodies are searched by the later body in the list. Awake dynamic bodies also search
+    // the bodies of sleeping islands overlapping them and wake up an island when a contact is found,
+    // its bodies are appended to the list and search their own pairs later in the same pass.
+    // Other bodies only move when they are placed by hand, then they wake up the islands they reach.
+    std::size_t countAwakeBodies = m_awakeBodies.size();
+    for (std::size_t i = 0; i < m_awakeBodies.size(); ++i) {
+        Body* bodyA = m_awakeBodies[i];
+        if (!bodyA->isEnabled() || bodyA->boundsTree().isEmpty())
             continue;
-        for (auto itB = itA + 1; itB != m_bodies.end(); ++itB) {
-            Body* bodyB = *itB;
-            if (!bodyB->isEnabled())
+        bool wokenUp = (i >= countAwakeBodies);
+        for (std::size_t j = 0; j < i; ++j) {
+            Body* bodyB = m_awakeBodies[j];
+            if (!bodyB->isEnabled() || (!bodyA->isDynamic() && !bodyB->isDynamic()))
+                continue;
+            if (wokenUp && (j < countAwakeBodies) && bodyB->isDynamic())
+                continue;
+            _updateCollision(bodyA, bodyB, xdt);
+        }
+        if (wokenUp)
+            continue;
+        if (!bodyA->isDynamic()) {
+            if (bodyA->m_sleepingCheckRevision != bodyA->m_transformRevision) {
+                bodyA->m_sleepingCheckRevision = bodyA->m_transformRevision;
+                _wakeUpSleepingIslands(bodyA->boundsTree().rootNode().bounds);
+            }
+            continue;
+        }
+        std::size_t countBodies = m_awakeBodies.size();
+        for (std::size_t j = countAwakeBodies; j < countBodies; ++j) {
+            Body* bodyB = m_awakeBodies[j];
+            if (bodyB->isEnabled())
+                _updateCollision(bodyA, bodyB, xdt);
+        }
+        const Bounds& bounds = bodyA->boundsTree().rootNode().bounds;
+        std::size_t k = 0;
+        while (k < m_sleepingIslands.size()) {
+            if (!m_sleepingIslands[k].bounds.collision(bounds)) {
+                ++k;
                 continue;
-            if (bodyA->isDynamic() || bodyB->isDynamic()) {
-                _updateCollision(bodyA->boundsTree(), bodyB->boundsTree(), xdt);
             }
+            std::size_t countManifolds = m_solver->countContactManifolds();
+            Body* body = m_sleepingIslands[k].body;
+            Body* bodyB = body;
+            do {
+                if (bodyB->isEnabled())
+                    _updateCollision(bodyA, bodyB, xdt);
+                bodyB = bodyB->m_nextSleeping;
+            } while (bodyB != body);
+            // A woken island leaves the list and the last one takes its place.
+            if (m_solver->countContactManifolds() > countManifolds)
+                _wakeUp(body);
+            else
+                ++k;
         }
     }
+    // Substeps keep adding to the swept motion until the next narrowphase.
+    for (auto it = m_awakeBodies.begin(); it != m_awakeBodies.end(); ++it) {
+        (*it)->m_sweptDistance = 0.0f;
+        (*it)->m_sweptAngle = 0.0f;
+    }
+}
+
+void PhysicsWorld::_updateCollision(Body* bodyA, Body* bodyB, float xdt)
+{
+    if (bodyA->m_index < bodyB->m_index)
+        _updateCollision(bodyA->boundsTree(), bodyB->boundsTree(), xdt);
+    else
+        _updateCollision(bodyB->boundsTree(), bodyA->boundsTree(), xdt);
 }
 
 void PhysicsWorld::_updateCollision(BoundsTree& boundsTreeA, BoundsTree& boundsTreeB, float xdt)
@@ -244,13 +757,13 @@ void PhysicsWorld::_updateCollision(Sphere* sphereA, Shape* shapeB, float xdt)
 {
     switch (shapeB->type()) {
     case TypeShape::Sphere: {
-        m_solver.collision(sphereA, static_cast<Sphere*>(shapeB), xdt);
+        m_solver->collision(sphereA, static_cast<Sphere*>(shapeB), xdt);
     } break;
     case TypeShape::Capsule: {
-        m_solver.collision(sphereA, static_cast<Capsule*>(shapeB), xdt);
+        m_solver->collision(sphereA, static_cast<Capsule*>(shapeB), xdt);
     } break;
     case TypeShape::Hull: {
-        m_solver.collision(sphereA, static_cast<Hull*>(shapeB), xdt);
+        m_solver->collision(sphereA, static_cast<Hull*>(shapeB), xdt);
     } break;
     default:
         break;
@@ -261,13 +774,13 @@ void PhysicsWorld::_updateCollision(Capsule* capsuleA, Shape* shapeB, float xdt)
 {
     switch (shapeB->type()) {
     case TypeShape::Sphere: {
-        m_solver.collision(capsuleA, static_cast<Sphere*>(shapeB), xdt);
+        m_solver->collision(capsuleA, static_cast<Sphere*>(shapeB), xdt);
     } break;
     case TypeShape::Capsule: {
-        m_solver.collision(capsuleA, static_cast<Capsule*>(shapeB), xdt);
+        m_solver->collision(capsuleA, static_cast<Capsule*>(shapeB), xdt);
     } break;
     case TypeShape::Hull: {
-        m_solver.collision(capsuleA, static_cast<Hull*>(shapeB), xdt);
+        m_solver->collision(capsuleA, static_cast<Hull*>(shapeB), xdt);
     } break;
     default:
         break;
@@ -278,13 +791,13 @@ void PhysicsWorld::_updateCollision(Hull* hullA, Shape* shapeB, float xdt)
 {
     switch (shapeB->type()) {
     case TypeShape::Sphere: {
-        m_solver.collision(hullA, static_cast<Sphere*>(shapeB), xdt);
+        m_solver->collision(hullA, static_cast<Sphere*>(shapeB), xdt);
     } break;
     case TypeShape::Capsule: {
-        m_solver.collision(hullA, static_cast<Capsule*>(shapeB), xdt);
+        m_solver->collision(hullA, static_cast<Capsule*>(shapeB), xdt);
     } break;
     case TypeShape::Hull: {
-        m_solver.collision(hullA, static_cast<Hull*>(shapeB), xdt);
+        m_solver->collision(hullA, static_cast<Hull*>(shapeB), xdt);
     } break;
     default:
         break;
@@ -2,34 +2,97 @@
 #define PE_PHYSICSWORLD_H
 
 #include <vector>
+#include <memory>
 #include "VectorMath/Vector3.h"
+#include "Memory/Allocator.h"
+#include "Memory/Pool.h"
+#include "Memory/ScratchArena.h"
+#include "Bodies/Body.h"
 #include "Bodies/Shape.h"
+#include "Bodies/Sphere.h"
+#include "Bodies/Capsule.h"
+#include "Bodies/Hull.h"
 #include "Bodies/BoundsTrees.h"
 #include "Dynamic/ShockPropagationSolver.h"
+#include "Dynamic/JacobiSolver.h"
 
 namespace PE {
 
+enum class SolverType
+{
+    ShockPropagation,
+    Jacobi
+};
+
+// Timings are in seconds. The iteration counts and shock propagation flag are the ones the step really used.
+// Substeps add their integration to timeBodies and their contact refresh to timeCollisions.
+struct UpdateReport
+{
+    float budget;
+    float time;
+    float timeBodies;
+    float timeCollisions;
+    float timeIslands;
+    float timeSolver;
+    int solverCountIterations;
+    int splitImpulsesIterations;
+    bool shockPropagation;
+    bool degraded;
+    bool overBudget;
+    // Heap allocations made during the update, counted only with PE_CountHeapAllocations.
+    std::size_t countHeapAllocations;
+};
+
 class Body;
 
 class PhysicsWorld
 {
 public:
-    PhysicsWorld(const Vector3& gravity = Vector3(0.0f, -9.81f, 0.0f));
+    PhysicsWorld(const Vector3& gravity = Vector3(0.0f, -9.81f, 0.0f), Allocator* allocator = nullptr);
     ~PhysicsWorld();
 
+    // Objects created here live in the pools of the world and have to be destroyed with destroyBody
+    // and destroyShape, which also accept objects created with new.
+    Body* createBody();
+    Sphere* createSphere(const Vector3& localPosition, float radius);
+    Capsule* createCapsule(float length, float radius);
+    Capsule* createCapsule(const Vector3& vertexA, const Vector3& vertexB, float radius);
+    Hull* createHull();
+    Hull* createHull(const std::shared_ptr<const ConvexGeometry>& geometry);
+    Shape* createCopy(const Shape* shape);
+    void destroyBody(Body* body);
+    void destroyShape(Shape* shape);
+
     float damp() const;
     void setDamp(float damp);
 
-    int countIterationsForCollisionGroups() const;
-    void setCountIterationsForCollisionGroups(int countIterationsForCollisionGroup);
+    SolverType solverType() const;
+    void setSolverType(SolverType solverType);
 
     bool enableShockPropagation() const;
     void setEnableShockPropagation(bool enable);
 
+    bool enableSeparationCache() const;
+    void setEnableSeparationCache(bool enable);
+
+    bool enableBlockSolver() const;
+    void setEnableBlockSolver(bool enable);
+
     void setCountIterations(int solverCountIterations, int splitImpulsesCountIterations);
     int solverCountIterations() const;
     int splitImpulsesIterations() const;
 
+    float solverResidualTolerance() const;
+    void setSolverResidualTolerance(float residualTolerance);
+
+    int countThreads() const;
+    void setCountThreads(int countThreads);
+
+    // Every update is split into substeps that integrate and solve again with the contacts of the first one,
+    // use it with one or two solver iterations instead of raising them.
+    int countSubsteps() const;
+    void setCountSubsteps(int countSubsteps);
+
     float sleepVelocity() const;
     void setSleepVelocity(float sleepVelocity);
 
@@ -38,25 +101,80 @@ public:
 
     const ContactsContainer& contactsContainer() const;
 
-    void update(float dt);
+    // Indices are dense and change when a body is removed, handles stay valid until their body is destroyed.
+    std::size_t countBodies() const;
+    Body* body(std::size_t index) const;
+    Body* body(BodyHandle handle) const;
+
+    const CollisionGroup& collisionGroup(std::uint32_t id) const;
+
+    // A positive budget lowers shock propagation, then split-impulse and then solver iterations
+    // for this step when the solver would not fit into the time left. It is checked again before every substep.
+    void update(float dt, float budget = 0.0f);
+    const UpdateReport& lastUpdateReport() const;
 
 private:
     friend class Body;
 
+    Allocator* m_allocator;
+    Pool<Body> m_bodyPool;
+    Pool<Sphere> m_spherePool;
+    Pool<Capsule> m_capsulePool;
+    Pool<Hull> m_hullPool;
+    ScratchArena m_scratchArena;
+
     Vector3 m_gravity;
     float m_damp;
     int m_sleepTime;
-    int m_countIterationsForCollisionGroups;
     float m_sleepVelocity;
     float m_sleepAngularVelocity;
-    std::vector<Body*> m_bodies;
-    ShockPropagationSolver m_solver;
+    struct BodySlot
+    {
+        Body* body;
+        std::uint32_t generation;
+    };
 
-    std::size_t _addBody(Body* body);
-    void _removeBody(std::size_t index);\
-
-    void _updateBodies(float dt);
+    std::vector<Body*> m_bodies;
+    std::vector<BodySlot> m_bodySlots;
+    std::vector<std::uint32_t> m_freeBodySlots;
+    // Indexed by the slot of the body owning the default group.
+    std::vector<CollisionGroup> m_collisionGroups;
+    // Bodies of sleeping islands are not listed here, static bodies always are.
+    std::vector<Body*> m_awakeBodies;
+    struct SleepingIsland
+    {
+        Bounds bounds;
+        Body* body;
+    };
+    // Awake bodies look for sleeping ones through the bounds of their islands.
+    std::vector<SleepingIsland> m_sleepingIslands;
+    SolverType m_solverType;
+    std::unique_ptr<Solver> m_solver;
+    bool m_enableShockPropagation;
+    int m_countSubsteps;
+    UpdateReport m_report;
+    float m_solverPassCost;
+
+    void _addBody(Body* body);
+    void _removeBody(Body* body);
+    void _removeShape(const Shape* shape);
+    CollisionGroup& _collisionGroup(const Body* body);
+    void _removeAwakeBody(Body* body);
+    void _wakeUp(Body* body);
+    void _sleep(Body* body, Body* nextSleeping);
+    void _addSleepingIsland(Body* body);
+    void _removeSleepingIsland(std::size_t index);
+    void _mergeSleepingBounds(const Body* body);
+    void _wakeUpSleepingIslands(const Bounds& bounds);
+
+    void _degradeSolver(float time, int countSolves);
+    std::size_t _countSolverPasses() const;
+    void _setSolverShockPropagation(bool enable);
+    void _updateBodies(float dt, float damping);
+    void _integrateBodies(float dt, float damping);
+    void _updateSleeping();
     void _updateCollisions(float xdt);
+    void _updateCollision(Body* bodyA, Body* bodyB, float xdt);
     void _updateCollision(BoundsTree& boundsTreeA, BoundsTree& boundsTreeB, float xdt);
     void _updateCollision(BoundsTree& boundsTreeA, BoundsTree::Node& nodeA,
                           BoundsTree& boundsTreeB, BoundsTree::Node& nodeB,
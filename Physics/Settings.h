@@ -4,6 +4,12 @@
 #include "VectorMath/Vector3.h"
 
 #define PE_BLOCK_SIZE 200
+#define PE_PoolBlockSize 64
+#define PE_ScratchArenaBlockSize (64 * 1024)
+// Replaces the global operator new to count heap allocations, see UpdateReport::countHeapAllocations.
+#ifndef PE_CountHeapAllocations
+#define PE_CountHeapAllocations 0
+#endif
 
 #define PE_DefaultMaxCountPoligonsOnConvexHull 2000
 #define PE_DefaultMaxCountVerticesOnPoligonsOnConvexHull 200
@@ -22,6 +28,16 @@
 
 #define PE_BodyInertia 1
 
+#define PE_SupportSIMD 1
+#define PE_SolverSIMD 1
+#define PE_SolverSIMDWidth 4
+#define PE_SolverIslandBatchSize 32
+#define PE_SolverColoringMinManifolds 128
+#define PE_SolverMaxColors 64
+#define PE_SolverResidualTolerance 1e-3f
+// The Jacobi solver applies only a fraction of each correction per iteration, so it stops on this share of the tolerance.
+#define PE_JacobiResidualToleranceScale 0.01f
+
 #define PE_default_mass 1.0f
 #if (PE_BodyInertia == 3)
 #define PE_default_inertia PE::Vector3(1.0f, 1.0f, 1.0f)
@@ -0,0 +1,98 @@
+#ifndef PE_MATRIX3_H
+#define PE_MATRIX3_H
+
+#include "Vector3.h"
+#include "RotationMatrix.h"
+
+namespace PE {
+
+class Matrix3
+{
+public:
+    Matrix3()
+    {
+        setToIdentity();
+    }
+
+    Matrix3(float diagonal)
+    {
+        setDiagonal(Vector3(diagonal));
+    }
+
+    void setToIdentity()
+    {
+        setDiagonal(Vector3(1.0f));
+    }
+
+    void setDiagonal(const Vector3& diagonal)
+    {
+        m_rows[0].set(diagonal.x, 0.0f, 0.0f);
+        m_rows[1].set(0.0f, diagonal.y, 0.0f);
+        m_rows[2].set(0.0f, 0.0f, diagonal.z);
+    }
+
+    // Sets rotation * diag(diagonal) * transpose(rotation), a diagonal tensor of local axes turned into world axes.
+    void setRotatedDiagonal(const RotationMatrix& rotation, const Vector3& diagonal)
+    {
+        const Vector3& a = rotation[0];
+        const Vector3& b = rotation[1];
+        const Vector3& c = rotation[2];
+        Vector3 da = a * diagonal.x, db = b * diagonal.y, dc = c * diagonal.z;
+        m_rows[0].set(da.x * a.x + db.x * b.x + dc.x * c.x,
+                      da.x * a.y + db.x * b.y + dc.x * c.y,
+                      da.x * a.z + db.x * b.z + dc.x * c.z);
+        m_rows[1].set(m_rows[0].y,
+                      da.y * a.y + db.y * b.y + dc.y * c.y,
+                      da.y * a.z + db.y * b.z + dc.y * c.z);
+        m_rows[2].set(m_rows[0].z,
+                      m_rows[1].z,
+                      da.z * a.z + db.z * b.z + dc.z * c.z);
+    }
+
+    Matrix3 transposed() const
+    {
+        Matrix3 result;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                result.m_rows[i][j] = m_rows[j][i];
+        return result;
+    }
+
+    const Vector3& operator[] (int row) const
+    {
+        return m_rows[row];
+    }
+
+    Vector3& operator[] (int row)
+    {
+        return m_rows[row];
+    }
+
+    Vector3 operator * (const Vector3& vector) const
+    {
+        return Vector3(dot(m_rows[0], vector), dot(m_rows[1], vector), dot(m_rows[2], vector));
+    }
+
+    Matrix3 operator * (const Matrix3& b) const
+    {
+        Matrix3 bt = b.transposed(), result;
+        for (int i = 0; i < 3; ++i)
+            result.m_rows[i].set(dot(m_rows[i], bt.m_rows[0]), dot(m_rows[i], bt.m_rows[1]), dot(m_rows[i], bt.m_rows[2]));
+        return result;
+    }
+
+    Matrix3 operator * (float a) const
+    {
+        Matrix3 result;
+        for (int i = 0; i < 3; ++i)
+            result.m_rows[i] = m_rows[i] * a;
+        return result;
+    }
+
+private:
+    Vector3 m_rows[3];
+};
+
+} // namespace PE
+
+#endif // PE_MATRIX3_H
@@ -0,0 +1,127 @@
+#ifndef PE_QUATERNION_H
+#define PE_QUATERNION_H
+
+#include <cmath>
+#include "Vector3.h"
+#include "RotationMatrix.h"
+
+namespace PE {
+
+// Unit quaternion of a rotation, (x, y, z) is the vector part and w is the scalar part.
+class Quaternion
+{
+public:
+    float x, y, z, w;
+
+    Quaternion()
+    {
+        setToIdentity();
+    }
+
+    Quaternion(float x, float y, float z, float w)
+    {
+        set(x, y, z, w);
+    }
+
+    void set(float x, float y, float z, float w)
+    {
+        this->x = x;
+        this->y = y;
+        this->z = z;
+        this->w = w;
+    }
+
+    void setToIdentity()
+    {
+        set(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    float lengthSquared() const
+    {
+        return x * x + y * y + z * z + w * w;
+    }
+
+    void normalize()
+    {
+        float l = lengthSquared();
+        if (l < PE_EPSf) {
+            setToIdentity();
+            return;
+        }
+        l = 1.0f / std::sqrt(l);
+        x *= l;
+        y *= l;
+        z *= l;
+        w *= l;
+    }
+
+    Vector3 vectorRotated(const Vector3& vector) const
+    {
+        Vector3 u(x, y, z);
+        Vector3 t = cross(u, vector) * 2.0f;
+        return vector + t * w + cross(u, t);
+    }
+
+    Vector3 vectorToAxis(const Vector3& vector) const
+    {
+        Vector3 u(- x, - y, - z);
+        Vector3 t = cross(u, vector) * 2.0f;
+        return vector + t * w + cross(u, t);
+    }
+
+    // Integrates the angular velocity in world space over dt: q += 0.5 * (angularVelocity, 0) * q * dt.
+    bool rotate(const Vector3& angularVelocity, float dt)
+    {
+        if (angularVelocity.lengthSquared() <= PE_EPSf * PE_EPSf)
+            return false;
+        Vector3 h = angularVelocity * (0.5f * dt);
+        float dx = h.x * w + h.y * z - h.z * y;
+        float dy = h.y * w + h.z * x - h.x * z;
+        float dz = h.z * w + h.x * y - h.y * x;
+        float dw = - (h.x * x + h.y * y + h.z * z);
+        x += dx;
+        y += dy;
+        z += dz;
+        w += dw;
+        normalize();
+        return true;
+    }
+
+    RotationMatrix toRotationMatrix() const
+    {
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+        RotationMatrix matrix;
+        matrix[0].set(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy));
+        matrix[1].set(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx));
+        matrix[2].set(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+        return matrix;
+    }
+
+    void fromRotationMatrix(const RotationMatrix& matrix)
+    {
+        const Vector3& a = matrix[0];
+        const Vector3& b = matrix[1];
+        const Vector3& c = matrix[2];
+        float trace = a.x + b.y + c.z;
+        if (trace > 0.0f) {
+            float s = std::sqrt(trace + 1.0f) * 2.0f;
+            set((b.z - c.y) / s, (c.x - a.z) / s, (a.y - b.x) / s, 0.25f * s);
+        } else if ((a.x > b.y) && (a.x > c.z)) {
+            float s = std::sqrt(1.0f + a.x - b.y - c.z) * 2.0f;
+            set(0.25f * s, (b.x + a.y) / s, (c.x + a.z) / s, (b.z - c.y) / s);
+        } else if (b.y > c.z) {
+            float s = std::sqrt(1.0f + b.y - a.x - c.z) * 2.0f;
+            set((b.x + a.y) / s, 0.25f * s, (c.y + b.z) / s, (c.x - a.z) / s);
+        } else {
+            float s = std::sqrt(1.0f + c.z - a.x - b.y) * 2.0f;
+            set((c.x + a.z) / s, (c.y + b.z) / s, 0.25f * s, (a.y - b.x) / s);
+        }
+        normalize();
+    }
+};
+
+} // namespace PE
+
+#endif // PE_QUATERNION_H
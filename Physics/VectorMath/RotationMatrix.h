@@ -1,6 +1,7 @@
 #ifndef PE_ROTATIONMATRIX_H
 #define PE_ROTATIONMATRIX_H
 
+#include <algorithm>
 #include "Vector3.h"
 
 namespace PE {
@@ -2,66 +2,6 @@
 
 namespace PE {
 
-float dot(const Vector3& a, const Vector3& b)
-{
-    return (a.x * b.x + a.y * b.y + a.z * b.z);
-}
-
-Vector3 cross(const Vector3& a, const Vector3& b)
-{
-    return Vector3(((a.y * b.z) - (a.z * b.y)),
-                   ((a.z * b.x) - (a.x * b.z)),
-                   ((a.x * b.y) - (a.y * b.x)));
-}
-
-Vector3 projection_n(const Vector3& rayNormal, const Vector3& rayPoint, const Vector3& point)
-{
-    float dpi = dot(point - rayPoint, rayNormal);
-    return (rayPoint + (rayNormal * dpi));
-}
-
-Vector3 projection(const Vector3& rayDir, const Vector3& rayPoint, const Vector3& point)
-{
-    float lengthSquared = rayDir.lengthSquared();
-    if (lengthSquared > PE_EPSf) {
-        float dpi = (dot(point - rayPoint, rayDir)) / lengthSquared;
-        return (rayPoint + (rayDir * dpi));
-    }
-    return point;
-}
-
-Vector3 projectionToPlane_n(const Vector3& planeNormal, const Vector3& planePoint, const Vector3& point)
-{
-    return (point - (planeNormal * dot(point - planePoint, planeNormal)));
-}
-
-Vector3 projectionToPlane(const Vector3& planeDir, const Vector3& planePoint, const Vector3& point)
-{
-    float lengthSquared = planeDir.lengthSquared();
-    if (lengthSquared > PE_EPSf) {
-        return (point - (planeDir * (dot(point - planePoint, planeDir) / lengthSquared)));
-    }
-    return point;
-}
-
-Vector3 sin(const Vector3& v)
-{
-    return Vector3(std::sin(v.x), std::sin(v.y), std::sin(v.z));
-}
-
-Vector3 cos(const Vector3& v)
-{
-    return Vector3(std::cos(v.x), std::cos(v.y), std::cos(v.z));
-}
-
-Vector3 rotateAroundVector(const Vector3& B, const Vector3& n, float angle)
-{
-    Vector3 dz = n * dot(n , B);
-    Vector3 dx = B - dz;
-    Vector3 dy = cross(n, dx);
-    return ((dx * std::cos(angle) + dy * std::sin(angle)) + dz);
-}
-
 /*inline bool getParametrT(vector3& pdir, vector3& dir, vector3& point, float& t)
 {
     if (abs(dir.x) > EPS) t = (point.x - pdir.x) / dir.x;
@@ -118,11 +58,11 @@ bool collisionLinesOnPlane(Vector3& result, float& tA, float& tB,
         if (!collisionPlaneRay(result, tA, dir, (- dot(pointB_1, dir)), pointA_1, pA_dir))
             return false;
         if ((tA >= 0.0f) && (tA <= 1.0f)) {
-            if (abs(pB_dir.x) > PE_EPSf)
+            if (std::fabs(pB_dir.x) > PE_EPSf)
                 tB = (result.x - pointB_1.x) / pB_dir.x;
-            else if (abs(pB_dir.y) > PE_EPSf)
+            else if (std::fabs(pB_dir.y) > PE_EPSf)
                 tB = (result.y - pointB_1.y) / pB_dir.y;
-            else if (abs(pB_dir.z) > PE_EPSf)
+            else if (std::fabs(pB_dir.z) > PE_EPSf)
                 tB = (result.z - pointB_1.z) / pB_dir.z;
             else
                 return false;
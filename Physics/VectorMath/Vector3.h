@@ -15,16 +15,14 @@ public:
         //x = y = z = 0.0f;
     }
 
-    Vector3(float x, float y, float z)
+    constexpr Vector3(float x, float y, float z):
+        x(x), y(y), z(z)
     {
-        this->x = x;
-        this->y = y;
-        this->z = z;
     }
 
-    Vector3(float a)
+    constexpr Vector3(float a):
+        x(a), y(a), z(a)
     {
-        x = y = z = a;
     }
 
     inline void set(float x, float y, float z)
@@ -34,14 +32,14 @@ public:
         this->z = z;
     }
 
-    Vector3 operator + (const Vector3& b) const
+    constexpr Vector3 operator + (const Vector3& b) const
     {
         return Vector3(x + b.x,
                        y + b.y,
                        z + b.z);
     }
 
-    Vector3 operator - (const Vector3& b) const
+    constexpr Vector3 operator - (const Vector3& b) const
     {
         return Vector3(x - b.x,
                        y - b.y,
@@ -76,12 +74,12 @@ public:
         z /= a;
     }
 
-    Vector3 operator * (float a) const
+    constexpr Vector3 operator * (float a) const
     {
         return Vector3(x * a, y * a, z * a);
     }
 
-    Vector3 operator / (float a) const
+    constexpr Vector3 operator / (float a) const
     {
         return Vector3(x / a, y / a, z / a);
     }
@@ -96,12 +94,12 @@ public:
         return (&x)[n];
     }
 
-    Vector3 operator - () const
+    constexpr Vector3 operator - () const
     {
         return Vector3( - x, - y, - z);
     }
 
-    float lengthSquared() const
+    constexpr float lengthSquared() const
     {
         return (x * x + y * y + z * z);
     }
@@ -235,23 +233,64 @@ public:
     }
 };
 
-float dot(const Vector3& a, const Vector3& b);
+constexpr float dot(const Vector3& a, const Vector3& b)
+{
+    return (a.x * b.x + a.y * b.y + a.z * b.z);
+}
 
-Vector3 cross(const Vector3& a, const Vector3& b);
+constexpr Vector3 cross(const Vector3& a, const Vector3& b)
+{
+    return Vector3(((a.y * b.z) - (a.z * b.y)),
+                   ((a.z * b.x) - (a.x * b.z)),
+                   ((a.x * b.y) - (a.y * b.x)));
+}
 
-Vector3 projection_n(const Vector3& rayNormal, const Vector3& rayPoint, const Vector3& point);
+constexpr Vector3 projection_n(const Vector3& rayNormal, const Vector3& rayPoint, const Vector3& point)
+{
+    return (rayPoint + (rayNormal * dot(point - rayPoint, rayNormal)));
+}
 
-Vector3 projection(const Vector3& rayDir, const Vector3& rayPoint, const Vector3& point);
+inline Vector3 projection(const Vector3& rayDir, const Vector3& rayPoint, const Vector3& point)
+{
+    float lengthSquared = rayDir.lengthSquared();
+    if (lengthSquared > PE_EPSf) {
+        float dpi = (dot(point - rayPoint, rayDir)) / lengthSquared;
+        return (rayPoint + (rayDir * dpi));
+    }
+    return point;
+}
 
-Vector3 projectionToPlane_n(const Vector3& planeNormal, const Vector3& planePoint, const Vector3& point);
+constexpr Vector3 projectionToPlane_n(const Vector3& planeNormal, const Vector3& planePoint, const Vector3& point)
+{
+    return (point - (planeNormal * dot(point - planePoint, planeNormal)));
+}
 
-Vector3 projectionToPlane(const Vector3& planeDir, const Vector3& planePoint, const Vector3& point);
+inline Vector3 projectionToPlane(const Vector3& planeDir, const Vector3& planePoint, const Vector3& point)
+{
+    float lengthSquared = planeDir.lengthSquared();
+    if (lengthSquared > PE_EPSf) {
+        return (point - (planeDir * (dot(point - planePoint, planeDir) / lengthSquared)));
+    }
+    return point;
+}
 
-Vector3 sin(const Vector3& v);
+inline Vector3 sin(const Vector3& v)
+{
+    return Vector3(std::sin(v.x), std::sin(v.y), std::sin(v.z));
+}
 
-Vector3 cos(const Vector3& v);
+inline Vector3 cos(const Vector3& v)
+{
+    return Vector3(std::cos(v.x), std::cos(v.y), std::cos(v.z));
+}
 
-Vector3 rotateAroundVector(const Vector3& B, const Vector3& n, float angle);
+inline Vector3 rotateAroundVector(const Vector3& B, const Vector3& n, float angle)
+{
+    Vector3 dz = n * dot(n , B);
+    Vector3 dx = B - dz;
+    Vector3 dy = cross(n, dx);
+    return ((dx * std::cos(angle) + dy * std::sin(angle)) + dz);
+}
 
 bool collisionPlaneRay(Vector3& result, float& t, const Vector3& planeNormal, float planeD,
                        const Vector3& rayPoint, const Vector3& rayDir);
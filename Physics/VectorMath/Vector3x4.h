@@ -0,0 +1,70 @@
+#ifndef PE_VECTOR3X4_H
+#define PE_VECTOR3X4_H
+
+#include <emmintrin.h>
+#include "Vector3.h"
+
+namespace PE {
+
+class Vector3x4
+{
+public:
+    __m128 x, y, z;
+
+    Vector3x4()
+    {
+    }
+
+    Vector3x4(__m128 x, __m128 y, __m128 z)
+    {
+        this->x = x;
+        this->y = y;
+        this->z = z;
+    }
+
+    static Vector3x4 load(const Vector3* v)
+    {
+        return Vector3x4(_mm_setr_ps(v[0].x, v[1].x, v[2].x, v[3].x),
+                         _mm_setr_ps(v[0].y, v[1].y, v[2].y, v[3].y),
+                         _mm_setr_ps(v[0].z, v[1].z, v[2].z, v[3].z));
+    }
+
+    void store(Vector3* v) const
+    {
+        alignas(16) float sx[4], sy[4], sz[4];
+        _mm_store_ps(sx, x);
+        _mm_store_ps(sy, y);
+        _mm_store_ps(sz, z);
+        for (int i = 0; i < 4; ++i)
+            v[i].set(sx[i], sy[i], sz[i]);
+    }
+
+    Vector3x4 operator + (const Vector3x4& b) const
+    {
+        return Vector3x4(_mm_add_ps(x, b.x), _mm_add_ps(y, b.y), _mm_add_ps(z, b.z));
+    }
+
+    Vector3x4 operator - (const Vector3x4& b) const
+    {
+        return Vector3x4(_mm_sub_ps(x, b.x), _mm_sub_ps(y, b.y), _mm_sub_ps(z, b.z));
+    }
+
+    Vector3x4 operator * (__m128 a) const
+    {
+        return Vector3x4(_mm_mul_ps(x, a), _mm_mul_ps(y, a), _mm_mul_ps(z, a));
+    }
+
+    Vector3x4 operator * (const Vector3x4& b) const
+    {
+        return Vector3x4(_mm_mul_ps(x, b.x), _mm_mul_ps(y, b.y), _mm_mul_ps(z, b.z));
+    }
+};
+
+inline __m128 dot(const Vector3x4& a, const Vector3x4& b)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+}
+
+} // namespace PE
+
+#endif // PE_VECTOR3X4_H
@@ -50,7 +50,7 @@ Scene::Scene(QScrollEngine::QScrollEngineWidget* widget):
     groundEntity->setName("Ground");
     groundEntity->addPart(cubeMesh, QShPtr(new QSh_Light(nullptr, QColor(155, 55, 0))));
     groundEntity->setScale(500.0f, 500.0f, 1.0f);
-    Body* groundBody = new Body(&m_physicsWorld);
+    Body* groundBody = m_physicsWorld.createBody();
     groundBody->setMass(0.0f);
     Hull* groundHull = new Hull();
     groundHull->setCountVertices(8);
@@ -81,41 +81,39 @@ Scene::Scene(QScrollEngine::QScrollEngineWidget* widget):
     sphereEntity->addPart(parentContext(), QGLPrimitiv::Primitives::Sphere, QShPtr(new QSh_Light));
     sphereEntity->setPosition(5.0f, 10.0f, 1.0f);
     QVector3D p = sphereEntity->position();
-    Body* sphereBody = new Body(&m_physicsWorld);
+    Body* sphereBody = m_physicsWorld.createBody();
     sphereBody->setPosition(Vector3(p.x(), p.y(), p.z()));
-    (new Sphere(Vector3(0.0f, 0.0f, 0.0f), 0.5f))->setBody(sphereBody);
+    m_physicsWorld.createSphere(Vector3(0.0f, 0.0f, 0.0f), 0.5f)->setBody(sphereBody);
     m_bodies.push_back(qMakePair(sphereBody, sphereEntity));
     m_planarShadows.addEntity(sphereEntity);
     for (i = 1; i < 10; ++i) {
         sphereEntity = sphereEntity->clone();
         sphereEntity->setPosition(sphereEntity->position() + QVector3D(0.0f, 0.0f, 1.0f));
         p = sphereEntity->position();
-        Body* sphereBody = new Body(&m_physicsWorld);
+        Body* sphereBody = m_physicsWorld.createBody();
         sphereBody->setPosition(Vector3(p.x(), p.y(), p.z()));
-        (new Sphere(Vector3(0.0f, 0.0f, 0.0f), 0.5f))->setBody(sphereBody);
+        m_physicsWorld.createSphere(Vector3(0.0f, 0.0f, 0.0f), 0.5f)->setBody(sphereBody);
         m_bodies.push_back(qMakePair(sphereBody, sphereEntity));
         m_planarShadows.addEntity(sphereEntity);
     }
 
-    Hull* cubeHull = new Hull();
-    cubeHull->setCountVertices(8);
-    cubeHull->setLocalVertex(0, Vector3(-0.5f, -0.5f, -0.5f));
-    cubeHull->setLocalVertex(1, Vector3(0.5f, -0.5f, -0.5f));
-    cubeHull->setLocalVertex(2, Vector3(-0.5f, 0.5f, -0.5f));
-    cubeHull->setLocalVertex(3, Vector3(0.5f, 0.5f, -0.5f));
-    cubeHull->setLocalVertex(4, Vector3(-0.5f, -0.5f, 0.5f));
-    cubeHull->setLocalVertex(5, Vector3(0.5f, -0.5f, 0.5f));
-    cubeHull->setLocalVertex(6, Vector3(-0.5f, 0.5f, 0.5f));
-    cubeHull->setLocalVertex(7, Vector3(0.5f, 0.5f, 0.5f));
-    cubeHull->formedHull();
+    std::vector<Vector3> cubeVertices(8);
+    cubeVertices[0].set(-0.5f, -0.5f, -0.5f);
+    cubeVertices[1].set(0.5f, -0.5f, -0.5f);
+    cubeVertices[2].set(-0.5f, 0.5f, -0.5f);
+    cubeVertices[3].set(0.5f, 0.5f, -0.5f);
+    cubeVertices[4].set(-0.5f, -0.5f, 0.5f);
+    cubeVertices[5].set(0.5f, -0.5f, 0.5f);
+    cubeVertices[6].set(-0.5f, 0.5f, 0.5f);
+    cubeVertices[7].set(0.5f, 0.5f, 0.5f);
+    std::shared_ptr<const ConvexGeometry> cubeGeometry = ConvexGeometry::create(cubeVertices);
     for (i = 8; i >= 0; --i) {
         for (j = 0; j < i; ++j) {
-            Body* cubeBody = new Body(&m_physicsWorld);
+            Body* cubeBody = m_physicsWorld.createBody();
             cubeBody->setPosition(Vector3(i * (1.0f + 0.05f) - j * 0.5f - 8.0f,
                                           10.0f,
                                           j * (1.0f + 0.05f) + 6.0f));
-            Hull* s = (Hull*)cubeHull->copy();
-            s->setBody(cubeBody);
+            m_physicsWorld.createHull(cubeGeometry)->setBody(cubeBody);
             cubeBody->updateShapes();
             cubeBody->updateBoundsTree();
             cubeBody->calculateLocalInertia();
@@ -125,7 +123,6 @@ Scene::Scene(QScrollEngine::QScrollEngineWidget* widget):
             m_planarShadows.addEntity(entity);
         }
     }
-    delete cubeHull;
 
     QEntity* capsuleEntity = new QEntity(this);
     capsuleEntity->setName("Capsule");
@@ -140,10 +137,10 @@ Scene::Scene(QScrollEngine::QScrollEngineWidget* widget):
     capsuleEntity->addPart(parentContext(), QGLPrimitiv::Primitives::Cylinder, QShPtr(new QSh_Light));
     capsuleEntity->setPosition(-7.0f, 11.0f, 1.0f);
 
-    Body* capsuleBody = new Body(&m_physicsWorld);
+    Body* capsuleBody = m_physicsWorld.createBody();
     p = capsuleEntity->position();
     capsuleBody->setPosition(Vector3(p.x(), p.y(), p.z()));
-    (new Capsule(1.0f, 0.5f))->setBody(capsuleBody);
+    m_physicsWorld.createCapsule(1.0f, 0.5f)->setBody(capsuleBody);
     m_bodies.push_back(qMakePair(capsuleBody, capsuleEntity));
     m_planarShadows.addEntity(capsuleEntity);
 
@@ -151,10 +148,10 @@ Scene::Scene(QScrollEngine::QScrollEngineWidget* widget):
         capsuleEntity = capsuleEntity->clone();
         capsuleEntity->setPosition(capsuleEntity->position() + QVector3D(0.0f, 0.0f, 2.0f));
 
-        Body* capsuleBody = new Body(&m_physicsWorld);
+        Body* capsuleBody = m_physicsWorld.createBody();
         p = capsuleEntity->position();
         capsuleBody->setPosition(Vector3(p.x(), p.y(), p.z()));
-        (new Capsule(1.0f, 0.5f))->setBody(capsuleBody);
+        m_physicsWorld.createCapsule(1.0f, 0.5f)->setBody(capsuleBody);
 
         m_bodies.push_back(qMakePair(capsuleBody, capsuleEntity));
         m_planarShadows.addEntity(capsuleEntity);
@@ -254,7 +251,7 @@ void Scene::_updatePhysic()
     for (auto it = m_bodies.begin(); it != m_bodies.end(); ++it) {
         Vector3 pos = it->first->position();
         it->second->setPosition(pos.x, pos.y, pos.z);
-        it->second->setOrientation(_toQuaternion(it->first->rotation()));
+        it->second->setOrientation(_toQuaternion(it->first->orientation()));
         if (it->first->isDynamic())
             _setColor(it->second, it->first);
     }
@@ -262,16 +259,9 @@ void Scene::_updatePhysic()
         _updateDebugContacts();
 }
 
-QQuaternion Scene::_toQuaternion(const PE::RotationMatrix& R) const
+QQuaternion Scene::_toQuaternion(const PE::Quaternion& orientation) const
 {
-    QMatrix3x3 m;
-    for (int i = 0; i < 3; ++i)
-        for (int j = 0; j < 3; ++j)
-            m(j, i) = R[i][j];
-    QQuaternion q;
-    QScrollEngine::QOtherMathFunctions::matrixToQuaternion(m, q);
-    q.normalize();
-    return q;
+    return QQuaternion(orientation.w, orientation.x, orientation.y, orientation.z);
 }
 
 void Scene::_initOriginalDebugContact()
@@ -396,15 +386,15 @@ PE::Body* Scene::_createHumanBody()
 {
     using namespace PE;
 
-    Body* body = new Body(&m_physicsWorld);
+    Body* body = m_physicsWorld.createBody();
 
     Hull* corpus = Hull::creeateCube(Vector3(1.0f, 0.5, 1.5f) * 0.5f);
     corpus->setBody(body);
 
-    Sphere* head = new Sphere(Vector3(0.0f, 0.0f, 1.5f), 0.5f);
+    Sphere* head = m_physicsWorld.createSphere(Vector3(0.0f, 0.0f, 1.5f), 0.5f);
     head->setBody(body);
 
-    Capsule* hands = new Capsule(Vector3(-3.0f, 0.0f, 0.0f), (3.0f, 0.0f, 0.0f), 0.2f);
+    Capsule* hands = m_physicsWorld.createCapsule(Vector3(-3.0f, 0.0f, 0.0f), (3.0f, 0.0f, 0.0f), 0.2f);
     hands->setBody(body);
 
     Hull* leftLeg = Hull::creeateCube();
@@ -431,11 +421,11 @@ void Scene::_shot()
     QScene::CameraInfo cameraInfo = this->cameraInfo();
     float vel = 50.0f;
 
-    Body* body = new Body(&m_physicsWorld);
+    Body* body = m_physicsWorld.createBody();
     body->setPosition(Vector3(cameraInfo.position.x(), cameraInfo.position.y(), cameraInfo.position.z()));
     body->setVelocity(- Vector3(cameraInfo.localZ.x() * vel, cameraInfo.localZ.y() * vel, cameraInfo.localZ.z() * vel));
 
-    Sphere* s = new Sphere(Vector3(0.0f, 0.0f, 0.0f), 0.5f);
+    Sphere* s = m_physicsWorld.createSphere(Vector3(0.0f, 0.0f, 0.0f), 0.5f);
     s->setBody(body);
 
     m_bodies.push_back(qMakePair(body, bullet));
@@ -449,12 +439,12 @@ void Scene::_setColor(QScrollEngine::QEntity* entity, PE::Body* body)
         return;
     }
     QColor c;
-    auto it = m_colors.find(body->currentCollionGroup());
+    auto it = m_colors.find(body->currentCollisionGroupId());
     if (it == m_colors.end()) {
         c.setRgbF((std::rand() % 255) / 255.0f,
                   (std::rand() % 255) / 255.0f,
                   (std::rand() % 255) / 255.0f, 1.0f);
-        m_colors.insert({ body->currentCollionGroup(), c });
+        m_colors.insert({ body->currentCollisionGroupId(), c });
     } else {
         c = it->second;
     }
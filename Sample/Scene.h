@@ -46,12 +46,12 @@ protected:
     QScrollEngine::QEntity* m_originalDebugContact;
     std::vector<QScrollEngine::QEntity*> m_debugContacts;
 
-    std::map<std::shared_ptr<const PE::CollisionGroup>, QColor> m_colors;
+    std::map<std::uint32_t, QColor> m_colors;
 
     QScrollEngine::QEntity* m_bulletEntity;
 
     void _updatePhysic();
-    QQuaternion _toQuaternion(const PE::RotationMatrix& R) const;
+    QQuaternion _toQuaternion(const PE::Quaternion& orientation) const;
     void _initOriginalDebugContact();
     void _updateDebugContacts();
     QScrollEngine::QEntity* _createHumanEntity();